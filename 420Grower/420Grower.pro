@@ -1,6 +1,7 @@
 QT       += core gui
 QT += multimedia\
-        sql
+        sql\
+        concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -18,9 +19,17 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    main.cpp
+    main.cpp \
+    gardenio.cpp \
+    logpanel.cpp \
+    lsystem.cpp \
+    plantglwidget.cpp
 
 HEADERS += \
+    gardenio.h \
+    logpanel.h \
+    lsystem.h \
+    plantglwidget.h
 
 FORMS += \
 
@@ -30,3 +39,5 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 RESOURCES +=
+
+include(../core/core.pri)
@@ -0,0 +1,304 @@
+#include "gardenio.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include <limits>
+
+namespace {
+const quint32 BinaryMagic = 0x5047444E; // "PGDN"
+const char* FormatName = "planter-garden";
+// The fewest bytes a plant can take: a binary record with an empty strain,
+// and a JSON line of "{}\n". A header claiming more plants than the rest of
+// the file can hold is corrupt
+const qint64 MinBinaryRecordBytes = 90;
+const qint64 MinJsonRecordBytes = 3;
+
+enum GenomeBits : quint8 { BitTwinNode = 0x1, BitTriploid = 0x2, BitSTS = 0x4 };
+enum PlantBits : quint8 { BitClone = 0x1, BitFemale = 0x2, BitHermie = 0x4 };
+
+QJsonObject genomeToJson(const PlantGenome& g) {
+    QJsonObject o;
+    o["strain"] = g.strain;
+    o["startColor"] = g.startColor.name(QColor::HexArgb);
+    o["endColor"] = g.endColor.name(QColor::HexArgb);
+    o["budDensity"] = g.budDensity;
+    o["rootPriority"] = g.rootPriority;
+    o["tipSpeed"] = g.tipSpeed;
+    o["recoveryRate"] = g.recoveryRate;
+    o["cloneSuccessRate"] = g.cloneSuccessRate;
+    o["nutrientUseRate"] = g.nutrientUseRate;
+    o["waterUseRate"] = g.waterUseRate;
+    o["foxTailingChance"] = g.foxTailingChance;
+    o["hermieChance"] = g.hermieChance;
+    o["coldShockThreshold"] = g.coldShockThreshold;
+    o["seedYield"] = g.seedYield;
+    o["sativaRatio"] = g.sativaRatio;
+    o["plantDensity"] = g.plantDensity;
+    o["maxHeight"] = g.maxHeight;
+    o["twinNode"] = g.twinNode;
+    o["triploid"] = g.triploid;
+    o["wasSTSConverted"] = g.wasSTSConverted;
+    return o;
+}
+
+// Missing keys keep the PlantGenome defaults, so older or hand-written files load
+void genomeFromJson(const QJsonObject& o, PlantGenome& g) {
+    g.strain = o.value("strain").toString(g.strain);
+    if (o.contains("startColor")) g.startColor = QColor(o.value("startColor").toString());
+    if (o.contains("endColor")) g.endColor = QColor(o.value("endColor").toString());
+    g.budDensity = o.value("budDensity").toDouble(g.budDensity);
+    g.rootPriority = o.value("rootPriority").toDouble(g.rootPriority);
+    g.tipSpeed = o.value("tipSpeed").toDouble(g.tipSpeed);
+    g.recoveryRate = o.value("recoveryRate").toDouble(g.recoveryRate);
+    g.cloneSuccessRate = o.value("cloneSuccessRate").toDouble(g.cloneSuccessRate);
+    g.nutrientUseRate = o.value("nutrientUseRate").toDouble(g.nutrientUseRate);
+    g.waterUseRate = o.value("waterUseRate").toDouble(g.waterUseRate);
+    g.foxTailingChance = o.value("foxTailingChance").toDouble(g.foxTailingChance);
+    g.hermieChance = o.value("hermieChance").toDouble(g.hermieChance);
+    g.coldShockThreshold = o.value("coldShockThreshold").toDouble(g.coldShockThreshold);
+    g.seedYield = o.value("seedYield").toInt(g.seedYield);
+    g.sativaRatio = o.value("sativaRatio").toDouble(g.sativaRatio);
+    g.plantDensity = o.value("plantDensity").toDouble(g.plantDensity);
+    g.maxHeight = o.value("maxHeight").toDouble(g.maxHeight);
+    g.twinNode = o.value("twinNode").toBool(g.twinNode);
+    g.triploid = o.value("triploid").toBool(g.triploid);
+    g.wasSTSConverted = o.value("wasSTSConverted").toBool(g.wasSTSConverted);
+}
+
+QJsonObject plantToJson(const Plant& p) {
+    QJsonObject o;
+    o["seed"] = qint64(p.seed);
+    o["age"] = p.age;
+    o["hydration"] = p.hydration;
+    o["nutrients"] = p.nutrients;
+    o["health"] = p.health;
+    o["isClone"] = p.isClone;
+    o["isFemale"] = p.isFemale;
+    o["isHermie"] = p.isHermie;
+    o["genome"] = genomeToJson(p.genome);
+    return o;
+}
+
+void plantFromJson(const QJsonObject& o, Plant& p) {
+    p.seed = quint32(o.value("seed").toDouble());
+    p.age = o.value("age").toInt(p.age);
+    p.hydration = o.value("hydration").toDouble(p.hydration);
+    p.nutrients = o.value("nutrients").toDouble(p.nutrients);
+    p.health = o.value("health").toDouble(p.health);
+    p.isClone = o.value("isClone").toBool(p.isClone);
+    p.isFemale = o.value("isFemale").toBool(p.isFemale);
+    p.isHermie = o.value("isHermie").toBool(p.isHermie);
+    genomeFromJson(o.value("genome").toObject(), p.genome);
+}
+}
+
+GardenWriter::GardenWriter(QIODevice* device, GardenFormat format) : device(device), format(format) {
+    if (format == GardenFormat::Binary) {
+        stream.setDevice(device);
+        stream.setVersion(QDataStream::Qt_5_12);
+        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    }
+}
+
+bool GardenWriter::begin(qint64 count) {
+    if (format == GardenFormat::Binary) {
+        stream << BinaryMagic << qint32(GardenSchemaVersion) << count;
+        return stream.status() == QDataStream::Ok;
+    }
+    QJsonObject header;
+    header["format"] = FormatName;
+    header["version"] = GardenSchemaVersion;
+    header["count"] = count;
+    return device->write(QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n') > 0;
+}
+
+bool GardenWriter::write(const Plant& p) {
+    if (format == GardenFormat::Json)
+        return device->write(QJsonDocument(plantToJson(p)).toJson(QJsonDocument::Compact) + '\n') > 0;
+
+    const PlantGenome& g = p.genome;
+    quint8 genomeBits = (g.twinNode ? BitTwinNode : 0) | (g.triploid ? BitTriploid : 0) | (g.wasSTSConverted ? BitSTS : 0);
+    quint8 plantBits = (p.isClone ? BitClone : 0) | (p.isFemale ? BitFemale : 0) | (p.isHermie ? BitHermie : 0);
+    stream << g.strain << quint32(g.startColor.rgba()) << quint32(g.endColor.rgba())
+           << g.budDensity << g.rootPriority << g.tipSpeed << g.recoveryRate
+           << g.cloneSuccessRate << g.nutrientUseRate << g.waterUseRate
+           << g.foxTailingChance << g.hermieChance << g.coldShockThreshold
+           << qint32(g.seedYield) << g.sativaRatio << g.plantDensity << g.maxHeight << genomeBits
+           << p.seed << qint32(p.age) << p.hydration << p.nutrients << p.health << plantBits;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool GardenWriter::finish() {
+    return format == GardenFormat::Binary ? stream.status() == QDataStream::Ok : true;
+}
+
+GardenReader::GardenReader(QIODevice* device) : device(device) {
+}
+
+bool GardenReader::begin() {
+    QByteArray magic = device->peek(4);
+    if (magic.size() == 4 && qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(magic.constData())) == BinaryMagic) {
+        format = GardenFormat::Binary;
+        stream.setDevice(device);
+        stream.setVersion(QDataStream::Qt_5_12);
+        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        quint32 m;
+        qint32 v;
+        stream >> m >> v >> expected;
+        if (stream.status() != QDataStream::Ok) {
+            error = "Truncated garden header";
+            return false;
+        }
+        if (v < 1 || expected < 0 || expected > device->bytesAvailable() / MinBinaryRecordBytes) {
+            error = QString("Bad garden header (schema %1, %2 plants)").arg(v).arg(expected);
+            return false;
+        }
+        schemaVersion = v;
+    } else {
+        format = GardenFormat::Json;
+        QByteArray first = device->readLine();
+        QJsonObject header = QJsonDocument::fromJson(first).object();
+        if (header.value("format").toString() == FormatName) {
+            schemaVersion = header.value("version").toInt();
+            expected = qint64(header.value("count").toDouble(-1));
+            if (schemaVersion < 1) {
+                error = "Bad garden header: no schema version";
+                return false;
+            }
+            if (expected > device->bytesAvailable() / MinJsonRecordBytes) {
+                error = QString("Bad garden header: %1 plants can't fit in the file").arg(expected);
+                return false;
+            }
+        } else {
+            // Version 0: one indented plant object from the old "Save Plant" button
+            legacy = first + device->readAll();
+            if (!QJsonDocument::fromJson(legacy).object().contains("strain")) {
+                error = "Not a PlantER garden file";
+                return false;
+            }
+            expected = 1;
+        }
+    }
+    if (schemaVersion > GardenSchemaVersion) {
+        error = QString("Garden was saved by a newer version (schema %1)").arg(schemaVersion);
+        return false;
+    }
+    return true;
+}
+
+bool GardenReader::next(Plant& p) {
+    p = Plant();
+    if (schemaVersion == 0) {
+        if (legacy.isEmpty()) return false;
+        QJsonObject o = QJsonDocument::fromJson(legacy).object();
+        legacy.clear();
+        p.genome.strain = o["strain"].toString();
+        p.age = o["age"].toInt();
+        p.genome.wasSTSConverted = o["wasSTS"].toBool();
+        p.genome.sativaRatio = o["sativaRatio"].toDouble();
+        p.seed = QRandomGenerator::global()->generate();
+        read++;
+        return true;
+    }
+
+    if (format == GardenFormat::Json) {
+        while (!device->atEnd()) {
+            QByteArray line = device->readLine().trimmed();
+            if (line.isEmpty()) continue;
+            QJsonParseError parseError;
+            QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+            if (!doc.isObject()) {
+                error = QString("Plant %1: %2").arg(read + 1).arg(parseError.errorString());
+                return false;
+            }
+            plantFromJson(doc.object(), p);
+            read++;
+            return true;
+        }
+        return false;
+    }
+
+    if (read >= expected || stream.atEnd()) return false;
+    PlantGenome& g = p.genome;
+    quint32 startColor, endColor;
+    qint32 seedYield, age;
+    quint8 genomeBits, plantBits;
+    stream >> g.strain >> startColor >> endColor
+           >> g.budDensity >> g.rootPriority >> g.tipSpeed >> g.recoveryRate
+           >> g.cloneSuccessRate >> g.nutrientUseRate >> g.waterUseRate
+           >> g.foxTailingChance >> g.hermieChance >> g.coldShockThreshold
+           >> seedYield >> g.sativaRatio >> g.plantDensity >> g.maxHeight >> genomeBits
+           >> p.seed >> age >> p.hydration >> p.nutrients >> p.health >> plantBits;
+    if (stream.status() != QDataStream::Ok) {
+        error = QString("Plant %1: unexpected end of file").arg(read + 1);
+        return false;
+    }
+    g.startColor = QColor::fromRgba(startColor);
+    g.endColor = QColor::fromRgba(endColor);
+    g.seedYield = seedYield;
+    g.twinNode = genomeBits & BitTwinNode;
+    g.triploid = genomeBits & BitTriploid;
+    g.wasSTSConverted = genomeBits & BitSTS;
+    p.age = age;
+    p.isClone = plantBits & BitClone;
+    p.isFemale = plantBits & BitFemale;
+    p.isHermie = plantBits & BitHermie;
+    read++;
+    return true;
+}
+
+bool saveGarden(const QString& path, const QList<Plant>& plants, GardenFormat format, QString* error) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    GardenWriter writer(&file, format);
+    bool ok = writer.begin(plants.size());
+    for (int i = 0; ok && i < plants.size(); ++i)
+        ok = writer.write(plants[i]);
+    ok = ok && writer.finish();
+    if (!ok) {
+        if (error) *error = file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool loadGarden(const QString& path, QList<Plant>& plants, QString* error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    GardenReader reader(&file);
+    if (!reader.begin()) {
+        if (error) *error = reader.errorString();
+        return false;
+    }
+
+    QList<Plant> loaded;
+    if (reader.count() > 0) loaded.reserve(int(qMin<qint64>(reader.count(), std::numeric_limits<int>::max())));
+    Plant p;
+    while (reader.next(p))
+        loaded.append(p);
+
+    if (!reader.errorString().isEmpty()) {
+        if (error) *error = reader.errorString();
+        return false;
+    }
+    if (reader.count() >= 0 && loaded.size() != reader.count()) {
+        if (error) *error = QString("File is truncated: expected %1 plants, found %2").arg(reader.count()).arg(loaded.size());
+        return false;
+    }
+    plants.swap(loaded);
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef GARDENIO_H
+#define GARDENIO_H
+
+#include <QDataStream>
+#include <QFile>
+
+#include "plant.h"
+
+// Garden save files.
+//
+// Two encodings of the same schema, both written and read one plant at a time
+// so memory stays flat however large the garden is:
+//
+//  - JSON lines: a header object {"format":"planter-garden","version":N,"count":N}
+//    on the first line, then one plant object per line. Human-readable and
+//    diff-friendly.
+//  - Binary: QDataStream with a 'PGDN' magic, version and count, then packed
+//    records. Roughly a fifth of the size and much faster.
+//
+// Bump GardenSchemaVersion when fields are added; readers fill in genome
+// defaults for fields an older file doesn't have. The original single-plant
+// JSON written by "Save Plant" still loads as version 0.
+
+const int GardenSchemaVersion = 1;
+
+enum class GardenFormat { Json, Binary };
+
+class GardenWriter {
+public:
+    GardenWriter(QIODevice* device, GardenFormat format);
+
+    bool begin(qint64 count);
+    bool write(const Plant& plant);
+    bool finish();
+
+private:
+    QIODevice* device;
+    GardenFormat format;
+    QDataStream stream;
+};
+
+class GardenReader {
+public:
+    explicit GardenReader(QIODevice* device);
+
+    // Reads the header and picks the encoding; false if the file isn't a garden
+    bool begin();
+    // Next plant, or false at the end of the file or on a bad record (see errorString())
+    bool next(Plant& plant);
+
+    int version() const { return schemaVersion; }
+    qint64 count() const { return expected; }
+    QString errorString() const { return error; }
+
+private:
+    QIODevice* device;
+    QDataStream stream;
+    GardenFormat format = GardenFormat::Json;
+    int schemaVersion = 0;
+    qint64 expected = -1;
+    qint64 read = 0;
+    QByteArray legacy; // a version 0 single-plant document
+    QString error;
+};
+
+// Whole-file helpers used by the Save/Load buttons. Saving goes through a
+// QSaveFile so a failed write never truncates the previous save.
+bool saveGarden(const QString& path, const QList<Plant>& plants, GardenFormat format, QString* error);
+bool loadGarden(const QString& path, QList<Plant>& plants, QString* error);
+
+#endif // GARDENIO_H
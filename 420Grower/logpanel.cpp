@@ -0,0 +1,103 @@
+#include "logpanel.h"
+
+#include <QComboBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListView>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+namespace {
+// About 20 repaints a second however fast messages come
+const int RefreshIntervalMs = 50;
+}
+
+LogPanel::LogPanel(int capacity, QWidget* parent) : QWidget(parent), buffer(capacity) {
+    model = new LogModel(&buffer, this);
+    view = new QListView;
+    view->setModel(model);
+    // Every row is one line: the view can place rows without measuring them
+    view->setUniformItemSizes(true);
+    view->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    severityPicker = new QComboBox;
+    severityPicker->addItem("All", int(LogSeverity::Info));
+    severityPicker->addItem("Warnings", int(LogSeverity::Warning));
+    severityPicker->addItem("Errors", int(LogSeverity::Error));
+    plantFilter = new QSpinBox;
+    plantFilter->setRange(-1, 1000000);
+    plantFilter->setValue(-1);
+    plantFilter->setSpecialValueText("Any plant");
+    plantFilter->setPrefix("#");
+    search = new QLineEdit;
+    search->setPlaceholderText("Filter");
+    search->setClearButtonEnabled(true);
+    QPushButton* exportButton = new QPushButton("Export...");
+    QPushButton* clearButton = new QPushButton("Clear");
+    status = new QLabel;
+
+    QHBoxLayout* filters = new QHBoxLayout;
+    filters->addWidget(severityPicker);
+    filters->addWidget(plantFilter);
+    filters->addWidget(search, 1);
+    filters->addWidget(exportButton);
+    filters->addWidget(clearButton);
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(filters);
+    layout->addWidget(view, 1);
+    layout->addWidget(status);
+
+    refreshTimer.setSingleShot(true);
+    connect(&refreshTimer, &QTimer::timeout, this, [this]() { refresh(); });
+    connect(severityPicker, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() { applyFilter(); });
+    connect(plantFilter, QOverload<int>::of(&QSpinBox::valueChanged), this, [this]() { applyFilter(); });
+    connect(search, &QLineEdit::textChanged, this, [this]() { applyFilter(); });
+    connect(exportButton, &QPushButton::clicked, this, [this]() { exportLog(); });
+    connect(clearButton, &QPushButton::clicked, this, [this]() {
+        buffer.clear();
+        refresh();
+    });
+    refresh();
+}
+
+void LogPanel::append(LogSeverity severity, int plant, quint16 code, const QString& text) {
+    buffer.append(severity, plant, code, text);
+    if (!refreshTimer.isActive()) refreshTimer.start(RefreshIntervalMs);
+}
+
+void LogPanel::refresh() {
+    // Keep following the newest entries unless the user has scrolled up
+    QScrollBar* bar = view->verticalScrollBar();
+    bool following = bar->value() == bar->maximum();
+    model->refresh();
+    if (following) view->scrollToBottom();
+    status->setText(QString("%1 shown, %2 kept of the last %3 messages")
+                    .arg(model->rowCount()).arg(buffer.size()).arg(buffer.endSeq()));
+}
+
+void LogPanel::applyFilter() {
+    LogFilter filter;
+    filter.minSeverity = LogSeverity(severityPicker->currentData().toInt());
+    filter.plant = plantFilter->value();
+    filter.text = search->text();
+    model->setFilter(filter);
+    view->scrollToBottom();
+    refresh();
+}
+
+void LogPanel::exportLog() {
+    QString file = QFileDialog::getSaveFileName(this, "Export Log", "420grower-log.tsv",
+                                                "Tab separated (*.tsv *.txt);;All files (*)");
+    if (file.isEmpty()) return;
+    QString error;
+    if (model->exportTo(file, &error))
+        append(LogSeverity::Info, -1, 0, QString("Exported %1 messages to %2").arg(model->rowCount()).arg(file));
+    else
+        append(LogSeverity::Error, -1, 0, "Export failed: " + error);
+}
@@ -0,0 +1,41 @@
+#ifndef LOGPANEL_H
+#define LOGPANEL_H
+
+#include <QWidget>
+#include <QTimer>
+
+#include "logbuffer.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QListView;
+class QSpinBox;
+
+// 420Grower's console: a bounded LogBuffer shown in a QListView with
+// severity, plant and text filters and export to a file. Appending only
+// writes to the ring; the view catches up at most RefreshIntervalMs later,
+// so a flood of messages costs one repaint per interval.
+class LogPanel : public QWidget {
+public:
+    explicit LogPanel(int capacity = 100000, QWidget* parent = nullptr);
+
+    void setCodeNames(const QStringList& names) { model->setCodeNames(names); }
+    void append(LogSeverity severity, int plant, quint16 code, const QString& text);
+
+private:
+    void refresh();
+    void applyFilter();
+    void exportLog();
+
+    LogBuffer buffer;
+    LogModel* model;
+    QListView* view;
+    QComboBox* severityPicker;
+    QSpinBox* plantFilter;
+    QLineEdit* search;
+    QLabel* status;
+    QTimer refreshTimer;
+};
+
+#endif // LOGPANEL_H
@@ -0,0 +1,264 @@
+#include "lsystem.h"
+
+#include <QtMath>
+
+LSystemRules compileRules(const PlantGenome& genome) {
+    LSystemRules r;
+    float sativa = qBound(0.0f, genome.sativaRatio, 1.0f);
+    float density = qMax(0.1f, genome.plantDensity);
+
+    // Sativas stretch and branch narrow; indicas stay squat and spread out
+    float internode = 9.0f + 6.0f * sativa;
+    float branchAngle = 55.0f - 20.0f * sativa;
+    float branchChance = qBound(0.2f, 0.55f * density, 1.0f);
+    float leafSize = (7.0f - 2.0f * sativa) * (genome.triploid ? 1.3f : 1.0f);
+    float budSize = 2.0f + 4.0f * genome.budDensity;
+    float foxtail = qBound(0.0f, genome.foxTailingChance * 6.0f, 1.0f);
+    float canopy = 0.75f + 0.5f * genome.rootPriority;
+    float mainRate = genome.tipSpeed * StemGrowthPerDay / internode; // internodes per day
+    quint16 flowerDay = quint16(qRound(40 + 15 * sativa));
+
+    r.maxStemLength = genome.maxHeight;
+    r.leafAspect = 0.45f - 0.25f * sativa;
+    r.maxBranchNodes[1] = qRound(4 + 3 * density);
+    r.maxBranchNodes[2] = qRound(2 + 2 * density);
+
+    // Main stem, vegetative: A -> I [L] [L] [+A] [-A]  (opposite pairs)
+    Production stem;
+    stem.minOrder = 0;
+    stem.maxOrder = 0;
+    stem.toDay = flowerDay - 1;
+    stem.rate = mainRate;
+    stem.succ << Emit(Sym::Internode, 0, internode, 1, 3)
+              << Emit(Sym::Leaf, 65, leafSize, 1, 10)
+              << Emit(Sym::Leaf, -65, leafSize, 1, 10)
+              << Emit(Sym::Apex, branchAngle, 0, branchChance, 8)
+              << Emit(Sym::Apex, -branchAngle, 0, branchChance, 8);
+    if (genome.twinNode) {
+        // Whorled node: a second, tighter branch pair at the same height
+        stem.succ << Emit(Sym::Apex, branchAngle * 0.5f, 0, branchChance * 0.8f, 6)
+                  << Emit(Sym::Apex, -branchAngle * 0.5f, 0, branchChance * 0.8f, 6);
+    }
+    r.productions << stem;
+
+    // Primary branches: A -> I [L] [+A]  (alternate)
+    Production branch;
+    branch.minOrder = 1;
+    branch.maxOrder = 1;
+    branch.toDay = flowerDay - 1;
+    branch.rate = mainRate * canopy * 0.8f;
+    branch.alternate = true;
+    branch.succ << Emit(Sym::Internode, 0, internode * 0.8f, 1, 6)
+                << Emit(Sym::Leaf, 55, leafSize * 0.8f, 1, 10)
+                << Emit(Sym::Apex, branchAngle * 0.8f, 0, branchChance * 0.4f, 8);
+    r.productions << branch;
+
+    // Secondary branches: A -> I [L]
+    Production twig = branch;
+    twig.minOrder = 2;
+    twig.maxOrder = 2;
+    twig.rate = mainRate * canopy * 0.6f;
+    twig.succ.clear();
+    twig.succ << Emit(Sym::Internode, 0, internode * 0.6f, 1, 8)
+              << Emit(Sym::Leaf, 50, leafSize * 0.6f, 1, 10);
+    r.productions << twig;
+
+    // Flowering, every order: A -> I B [C [C [C]]]  (calyxes stack into foxtails)
+    Production flower;
+    flower.minOrder = 0;
+    flower.maxOrder = 2;
+    flower.fromDay = flowerDay;
+    flower.rate = mainRate * 0.6f;
+    flower.alternate = true;
+    flower.flowering = true;
+    flower.succ << Emit(Sym::Internode, 0, internode * 0.35f, 1, 4)
+                << Emit(Sym::Bud, 0, budSize)
+                << Emit(Sym::Leaf, 40, leafSize * 0.5f, 0.5f, 10)
+                << Emit(Sym::Calyx, 10, budSize * 0.6f, foxtail, 20)
+                << Emit(Sym::Calyx, -10, budSize * 0.5f, foxtail, 20)
+                << Emit(Sym::Calyx, 10, budSize * 0.4f, foxtail, 20);
+    r.productions << flower;
+
+    return r;
+}
+
+quint32 PlantMorphology::hashGenome(const PlantGenome& genome) {
+    const float traits[] = {
+        genome.budDensity, genome.rootPriority, genome.tipSpeed, genome.foxTailingChance,
+        genome.sativaRatio, genome.plantDensity, genome.maxHeight,
+        float(genome.twinNode), float(genome.triploid)
+    };
+    return qHashBits(traits, sizeof(traits));
+}
+
+PlantMorphology::PlantMorphology(const PlantGenome& genome, quint32 seed)
+    : rules(compileRules(genome)), rng(seed), genomeHash(hashGenome(genome)) {
+    geometryCache.setMaxCost(128); // days
+
+    // Axiom: a single apex on the soil line
+    ApexState seedling;
+    seedling.tip = -1;
+    seedling.pendingAngle = 0.0f;
+    seedling.order = 0;
+    apices << seedling;
+}
+
+qint32 PlantMorphology::addNode(qint32 parent, Sym sym, float angle, float size, int day, quint8 order) {
+    Node n;
+    n.parent = parent;
+    n.angle = angle;
+    n.size = size;
+    n.birthDay = quint16(day);
+    n.sym = sym;
+    n.order = order;
+    nodes << n;
+    return nodes.size() - 1;
+}
+
+void PlantMorphology::expandDay(int day) {
+    // Apices spawned today start growing tomorrow
+    int count = apices.size();
+    for (int a = 0; a < count; ++a) {
+        const Production* rule = nullptr;
+        for (const Production& p : rules.productions) {
+            if (apices[a].order >= p.minOrder && apices[a].order <= p.maxOrder && day >= p.fromDay && day <= p.toDay) {
+                rule = &p;
+                break;
+            }
+        }
+        if (!rule) continue;
+
+        apices[a].growth += rule->rate;
+        while (apices[a].growth >= 1.0f) {
+            apices[a].growth -= 1.0f;
+
+            ApexState& apex = apices[a];
+            if (rule->flowering) {
+                if (apex.flowerNodes >= rules.maxFlowerNodes) break;
+                apex.flowerNodes++;
+            } else if (apex.order == 0) {
+                if (apex.stemLength >= rules.maxStemLength) break;
+            } else if (apex.vegNodes >= rules.maxBranchNodes[apex.order]) {
+                break;
+            }
+
+            float sign = (rule->alternate && apex.mirror) ? -1.0f : 1.0f;
+            apex.mirror = !apex.mirror;
+            qint32 cursor = apex.tip;
+            qint32 stack = -1;  // what the next calyx grows on: the bud, then the calyx before it
+            quint8 order = apex.order;
+            QVector<ApexState> spawned;
+
+            for (const Emit& e : rule->succ) {
+                if (e.chance < 1.0f && rng.generateDouble() >= e.chance) continue;
+                float angle = sign * e.angle + (e.jitter > 0 ? float(rng.generateDouble() * 2 - 1) * e.jitter : 0.0f);
+
+                switch (e.sym) {
+                case Sym::Internode:
+                    if (apex.pendingAngle != 0.0f) {
+                        angle += apex.pendingAngle;
+                        apex.pendingAngle = 0.0f;
+                    }
+                    cursor = addNode(cursor, Sym::Internode, angle, e.size, day, order);
+                    apex.stemLength += e.size;
+                    apex.vegNodes++;
+                    break;
+                case Sym::Apex:
+                    if (order < 2) {
+                        ApexState side;
+                        side.tip = cursor;
+                        side.pendingAngle = angle;
+                        side.order = order + 1;
+                        spawned << side;
+                    }
+                    break;
+                case Sym::Bud:
+                    stack = addNode(cursor, Sym::Bud, angle, e.size, day, order);
+                    break;
+                case Sym::Calyx:
+                    stack = addNode(stack >= 0 ? stack : cursor, Sym::Calyx, angle, e.size, day, order);
+                    break;
+                default:
+                    addNode(cursor, e.sym, angle, e.size, day, order);
+                    break;
+                }
+            }
+            apex.tip = cursor;
+            apices << spawned; // may reallocate, so `apex` is not used past here
+        }
+    }
+}
+
+void PlantMorphology::grow(int day) {
+    day = qBound(0, day, 0xfffe);
+    while (nodesByDay.size() <= day) {
+        expandDay(nodesByDay.size());
+        nodesByDay << nodes.size();
+    }
+}
+
+const PlantGeometry& PlantMorphology::geometry(int day) {
+    day = qMax(0, day);
+    if (PlantGeometry* cached = geometryCache.object(day))
+        return *cached;
+    grow(day);
+    PlantGeometry* geo = new PlantGeometry(buildGeometry(day));
+    geometryCache.insert(day, geo, 1);
+    return *geo;
+}
+
+PlantGeometry PlantMorphology::buildGeometry(int day) const {
+    PlantGeometry geo;
+    int count = nodesByDay.value(day, nodes.size());
+    QVector<QPointF> tip(count);
+    QVector<float> dir(count);
+    float minX = 0, maxX = 0, minY = 0, maxY = 0;
+
+    for (int i = 0; i < count; ++i) {
+        const Node& n = nodes[i];
+        QPointF origin = n.parent < 0 ? QPointF(0, 0) : tip[n.parent];
+        float d = (n.parent < 0 ? 90.0f : dir[n.parent]) + n.angle;
+        float maturity = qMin(1.0f, float(day - n.birthDay + 1) / rules.matureDays);
+        float size = n.size * maturity;
+        float rad = qDegreesToRadians(d);
+        QPointF unit(qCos(rad), -qSin(rad));
+        dir[i] = d;
+
+        switch (n.sym) {
+        case Sym::Internode:
+            tip[i] = origin + unit * size;
+            geo.stems[qMin<int>(n.order, 2)] << QLineF(origin, tip[i]);
+            break;
+        case Sym::Leaf: {
+            // Diamond blade pointing along the leaf direction
+            QPointF end = origin + unit * (size * 2.0f);
+            QPointF side(-unit.y() * size * rules.leafAspect, unit.x() * size * rules.leafAspect);
+            QPointF mid = origin + unit * size;
+            QPolygonF blade;
+            blade << origin << mid + side << end << mid - side << origin;
+            geo.leaves.addPolygon(blade);
+            tip[i] = origin;
+            break;
+        }
+        case Sym::Bud:
+            geo.buds.addEllipse(origin, size, size);
+            tip[i] = origin;
+            break;
+        case Sym::Calyx:
+            tip[i] = origin + unit * (size * 1.2f);
+            geo.buds.addEllipse(tip[i], size, size);
+            break;
+        default:
+            tip[i] = origin;
+            break;
+        }
+
+        minX = qMin(minX, float(tip[i].x()));
+        maxX = qMax(maxX, float(tip[i].x()));
+        minY = qMin(minY, float(tip[i].y()));
+        maxY = qMax(maxY, float(tip[i].y()));
+    }
+
+    geo.bounds = QRectF(QPointF(minX, minY), QPointF(maxX, maxY)).united(geo.leaves.boundingRect());
+    return geo;
+}
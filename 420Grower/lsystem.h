@@ -0,0 +1,127 @@
+#ifndef LSYSTEM_H
+#define LSYSTEM_H
+
+#include <QVector>
+#include <QLineF>
+#include <QPainterPath>
+#include <QRandomGenerator>
+#include <QCache>
+
+#include "plant.h"
+
+// Parametric, stochastic L-system for plant shape.
+//
+// The grammar is bracketed in spirit (apices spawn side apices that grow their
+// own branches) but is expanded straight into a tree of nodes rather than a
+// flat string: productions only ever append nodes, so expanding day N+1 reuses
+// everything built up to day N, and the plant at an earlier day is simply a
+// prefix of the node array.
+
+enum class Sym : quint8 {
+    Apex,       // growing tip, the only symbol with productions
+    Internode,  // stem segment, advances the tip
+    Leaf,       // fan leaf, side organ
+    Bud,        // flower site, side organ
+    Calyx       // foxtail calyx stacked on a bud
+};
+
+// One symbol of a production's successor
+struct Emit {
+    Emit(Sym sym = Sym::Leaf, float angle = 0.0f, float size = 0.0f, float chance = 1.0f, float jitter = 0.0f)
+        : sym(sym), angle(angle), size(size), chance(chance), jitter(jitter) {}
+
+    Sym sym;
+    float angle;   // degrees relative to the tip direction (mirrored on alternate nodes)
+    float size;    // length for Internode, radius for organs
+    float chance;  // stochastic rule: probability this symbol is produced
+    float jitter;  // random spread added to angle, degrees
+};
+
+// Apex -> successor, active for a range of branch orders and days
+struct Production {
+    quint8 minOrder = 0, maxOrder = 0;
+    quint16 fromDay = 0, toDay = 0xffff;
+    float rate = 1.0f;    // firings per day; fractional rates accumulate
+    bool alternate = false; // mirror angles on every other firing (alternate phyllotaxy)
+    bool flowering = false;
+    QVector<Emit> succ;
+};
+
+// Rule table compiled from a genome. Trait values are folded into the
+// productions up front so expansion never has to look at the genome again.
+struct LSystemRules {
+    QVector<Production> productions;
+    float maxStemLength = 300.0f;   // main stem stops extending past this
+    int maxBranchNodes[3] = { 0, 7, 4 };
+    int matureDays = 6;             // days for a new segment to reach full size
+    float leafAspect = 0.4f;        // leaf width / length
+    int maxFlowerNodes = 5;         // bud clusters per apex once flowering
+};
+
+LSystemRules compileRules(const PlantGenome& genome);
+
+// Growth per day of the main stem at tipSpeed 1, in world pixels
+const float StemGrowthPerDay = 2.5f;
+
+inline float stemHeightAt(const PlantGenome& genome, int day) {
+    return qMin(day * genome.tipSpeed * StemGrowthPerDay, genome.maxHeight);
+}
+
+// Drawable output for one day, in plant-local coordinates (base at 0,0, y up is negative)
+struct PlantGeometry {
+    QVector<QLineF> stems[3];   // by branch order, drawn with decreasing pen widths
+    QPainterPath leaves;
+    QPainterPath buds;
+    QRectF bounds;
+};
+
+class PlantMorphology {
+public:
+    PlantMorphology(const PlantGenome& genome, quint32 seed);
+
+    // Expand the grammar up to and including `day`. Days already expanded are kept.
+    void grow(int day);
+
+    // Geometry as it looks on `day`; cached, so repeated scrubbing is free
+    const PlantGeometry& geometry(int day);
+
+    int nodeCount() const { return nodes.size(); }
+    quint32 fingerprint() const { return genomeHash; }
+
+    static quint32 hashGenome(const PlantGenome& genome);
+
+private:
+    struct Node {
+        qint32 parent;     // -1 for the seedling root
+        float angle;       // degrees relative to the parent's direction
+        float size;
+        quint16 birthDay;
+        Sym sym;
+        quint8 order;
+    };
+
+    struct ApexState {
+        qint32 tip;        // node this apex grows from
+        float pendingAngle;// applied to the first internode of a new branch
+        float growth = 0.0f;
+        float stemLength = 0.0f;
+        int vegNodes = 0;
+        int flowerNodes = 0;
+        quint8 order;
+        bool mirror = false;
+    };
+
+    void expandDay(int day);
+    qint32 addNode(qint32 parent, Sym sym, float angle, float size, int day, quint8 order);
+    PlantGeometry buildGeometry(int day) const;
+
+    LSystemRules rules;
+    QRandomGenerator rng;
+    QVector<Node> nodes;
+    QVector<ApexState> apices;
+    QVector<int> nodesByDay;   // node count after each expanded day
+    QCache<int, PlantGeometry> geometryCache;
+    quint32 genomeHash;
+};
+
+#endif // LSYSTEM_H
@@ -1,28 +1,3 @@
-// cannabis_simulator.cpp
-// Qt 5.12 + OpenGL Cannabis Growth & Breeding Simulator
-// Step 3: Basic OpenGL Plant Visualization
-
-#include <QApplication>
-#include <QMainWindow>
-#include <QVBoxLayout>
-#include <QHBoxLayout>
-#include <QPushButton>
-#include <QSlider>
-#include <QLabel>
-#include <QTextEdit>
-#include <QListWidget>
-#include <QSplitter>
-#include <QOpenGLWidget>
-#include <QTimer>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QFileDialog>
-#include <QFile>
-#include <QPainter>
-#include <QDateTime>
-#include <QRandomGenerator>
-#include <QtMath>
-
 // cannabis_simulator.cpp
 // Qt 5.12 + OpenGL Cannabis Growth & Breeding Simulator
 // Step 5.1: Add curved/randomized branching & denser leaves
@@ -33,161 +8,38 @@
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QSlider>
+#include <QSpinBox>
 #include <QLabel>
-#include <QTextEdit>
 #include <QListWidget>
 #include <QSplitter>
-#include <QOpenGLWidget>
 #include <QTimer>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QFileDialog>
-#include <QFile>
-#include <QPainter>
-#include <QDateTime>
 #include <QRandomGenerator>
-#include <QtMath>
-
-// Enhanced genome structure
-struct PlantGenome {
-    QString strain = "Unnamed";
-    QColor startColor = Qt::green;
-    QColor endColor = Qt::darkGreen;
-
-    float budDensity = 0.8f; // 0–1
-    float rootPriority = 0.5f; // 0=root, 1=canopy
-    float tipSpeed = 1.0f;     // tip growth multiplier
-    float recoveryRate = 0.75f;
-
-    float cloneSuccessRate = 0.85f;
-    float nutrientUseRate = 1.0f;
-    float waterUseRate = 1.0f;
-
-    float foxTailingChance = 0.05f;
-    float hermieChance = 0.03f;
-    float coldShockThreshold = 12.0f;
-
-    int seedYield = 50;
-    float sativaRatio = 0.5f; // 0 = indica, 1 = sativa
-
-    float plantDensity = 1.0f; // 1 = default spacing, >1 = more branches
-    float maxHeight = 300.0f;  // max height for full maturity
-
-    bool twinNode = false;
-    bool triploid = false;
-    bool wasSTSConverted = false;
-};
-
-struct Plant {
-    PlantGenome genome;
-    int age = 0;
-    float hydration = 1.0f; // 0–1
-    float nutrients = 1.0f;
-    float health = 1.0f;    // 0–1
-    bool isClone = false;
-    bool isFemale = true;
-    bool isHermie = false;
-};
-
-class PlantGLWidget : public QOpenGLWidget {
-public:
-    QList<Plant>* plants;
-    PlantGLWidget(QList<Plant>* p, QWidget* parent = nullptr) : QOpenGLWidget(parent), plants(p) {}
-
-protected:
-    void drawBranch(QPainter& painter, QPointF start, float angle, int depth, float length, const Plant& plant) {
-        if (depth <= 0) return;
-
-        float curve = QRandomGenerator::global()->bounded(10.0f); // curve factor
-        float dx = length * qCos(qDegreesToRadians(angle + curve));
-        float dy = -length * qSin(qDegreesToRadians(angle + curve));
-        QPointF end(start.x() + dx, start.y() + dy);
-
-        QPen thinPen(painter.pen().color());
-        thinPen.setWidthF(0.8);
-        painter.setPen(thinPen);
-        painter.drawLine(start, end);
-
-        // Dense leaf along branch
-        painter.setBrush(Qt::darkGreen);
-        for (int i = 1; i <= 3; ++i) {
-            float t = i / 4.0f;
-            QPointF mid(start.x() + t * dx, start.y() + t * dy);
-            painter.drawEllipse(mid, 4, 2);
-        }
-
-        // Budsite at tip
-        if (depth == 1) {
-            painter.setBrush(Qt::magenta);
-            float budSize = plant.genome.budDensity * 5.0f;
-            painter.drawEllipse(end, budSize, budSize);
-        }
-
-        float nextLen = length * 0.7f;
-        drawBranch(painter, end, angle - 20 + QRandomGenerator::global()->bounded(10), depth - 1, nextLen, plant);
-        drawBranch(painter, end, angle + 20 + QRandomGenerator::global()->bounded(10), depth - 1, nextLen, plant);
-    }
-
-    void paintEvent(QPaintEvent*) override {
-        QPainter painter(this);
-        painter.fillRect(rect(), Qt::black);
-
-        int plantIndex = 0;
-        for (const Plant& plant : *plants) {
-            float stemHeight = qMin(plant.age * plant.genome.tipSpeed, plant.genome.maxHeight);
-            float baseY = this->height() - 20;
-            float baseX = 50 + plantIndex * 120;
-
-            QColor interpColor = QColor(
-                plant.genome.startColor.red()   + (plant.genome.endColor.red()   - plant.genome.startColor.red()) * (plant.age / 90.0f),
-                plant.genome.startColor.green() + (plant.genome.endColor.green() - plant.genome.startColor.green()) * (plant.age / 90.0f),
-                plant.genome.startColor.blue()  + (plant.genome.endColor.blue()  - plant.genome.startColor.blue()) * (plant.age / 90.0f)
-            );
-            painter.setPen(interpColor);
-            painter.setBrush(interpColor);
-
-            // Draw main stem
-            painter.drawRect(baseX, baseY - stemHeight, 6, stemHeight);
-
-            // Draw curved, random branches
-            int spacing = qRound(20 / plant.genome.plantDensity);
-            for (int y = spacing, i = 0; y < stemHeight; y += spacing, i++) {
-                QPointF node(baseX + 3, baseY - y);
-                float branchLen = 30 + (1.0f - float(y) / stemHeight) * 40;
-                float upwardAngle = -70 + QRandomGenerator::global()->bounded(15);
-                float mirrorAngle = 45 - upwardAngle + QRandomGenerator::global()->bounded(15);
-                if (i % 2 == 0) {
-                    drawBranch(painter, node, -upwardAngle, 3, branchLen, plant);
-                } else {
-                    drawBranch(painter, node, mirrorAngle, 3, branchLen, plant);
-                }
-            }
-
-            // Top bud
-            painter.setBrush(Qt::magenta);
-            float budSize = plant.genome.budDensity * 10.0f;
-            painter.drawEllipse(QPointF(baseX + 3, baseY - stemHeight), budSize, budSize);
-
-            // Draw label
-            QString label = QString("%1 (%2d)%3")
-                .arg(plant.genome.strain)
-                .arg(plant.age)
-                .arg(plant.isHermie ? " H" : "");
-            painter.setPen(Qt::white);
-            painter.drawText(baseX - 10, baseY - stemHeight - 10, label);
-
-            plantIndex++;
-        }
-    }
-};
-
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+#include "plant.h"
+#include "plantglwidget.h"
+#include "breeding.h"
+#include "eventlog.h"
+#include "gardenio.h"
+#include "logpanel.h"
+#include "timeline.h"
+
+// What a log message is about; LogNames gives them names for filtering and export
+enum LogCode : quint16 { LogGeneral, LogWater, LogFeed, LogSTS, LogClone, LogBreed, LogEvolve, LogFile };
+const QStringList LogNames = {"general", "water", "feed", "sts", "clone", "breed", "evolve", "file"};
 
 class MainWindow : public QMainWindow {
     QList<Plant> plants;
-    QTextEdit* console;
+    LogPanel* console;
     PlantGLWidget* glWidget;
     QSlider* daySlider;
+    QSpinBox* checkpointSpin;
     int currentDay = 0;
+    GardenTimeline timeline;
+    EventLog events;
     QTimer* timer;
 
 public:
@@ -202,13 +54,15 @@ public:
         QPushButton* btnSTS = new QPushButton("Apply STS");
         QPushButton* btnClone = new QPushButton("Clone");
         QPushButton* btnBreed = new QPushButton("Breed");
-        QPushButton* btnSave = new QPushButton("Save Plant");
-        QPushButton* btnLoad = new QPushButton("Load Plant");
+        QPushButton* btnEvolve = new QPushButton("Evolve Strain");
+        QPushButton* btnSave = new QPushButton("Save Garden");
+        QPushButton* btnLoad = new QPushButton("Load Garden");
         tools->addWidget(btnWater);
         tools->addWidget(btnFeed);
         tools->addWidget(btnSTS);
         tools->addWidget(btnClone);
         tools->addWidget(btnBreed);
+        tools->addWidget(btnEvolve);
         tools->addWidget(btnSave);
         tools->addWidget(btnLoad);
         tools->addStretch();
@@ -218,11 +72,20 @@ public:
         glWidget = new PlantGLWidget(&plants);
         glWidget->setMinimumHeight(300);
         daySlider = new QSlider(Qt::Horizontal);
-        daySlider->setRange(0, 90);
-        console = new QTextEdit;
-        console->setReadOnly(true);
+        daySlider->setRange(0, 120);
+        checkpointSpin = new QSpinBox;
+        checkpointSpin->setRange(1, 60);
+        checkpointSpin->setValue(timeline.checkpointInterval());
+        checkpointSpin->setSuffix(" days");
+        checkpointSpin->setToolTip("Snapshot interval for the day slider: shorter scrubs faster, longer uses less memory");
+        QHBoxLayout* timeRow = new QHBoxLayout;
+        timeRow->addWidget(daySlider, 1);
+        timeRow->addWidget(new QLabel("Checkpoint every"));
+        timeRow->addWidget(checkpointSpin);
+        console = new LogPanel;
+        console->setCodeNames(LogNames);
         view->addWidget(glWidget);
-        view->addWidget(daySlider);
+        view->addLayout(timeRow);
         view->addWidget(console);
 
         mainLayout->addLayout(tools, 1);
@@ -230,74 +93,175 @@ public:
         setCentralWidget(central);
         resize(800, 600);
 
+        // Water and Feed are kept in an events table like GardenDemo's alerts
+        QString error;
+        if (!events.open(QApplication::applicationDirPath() + "/grower_events.db", &error))
+            log("Event log unavailable: " + error, LogGeneral, -1, LogSeverity::Warning);
+
         // Demo data
         Plant p;
         p.genome.strain = "AK-47";
+        p.seed = QRandomGenerator::global()->generate();
         plants.append(p);
-        glWidget->update();
+        gardenChanged();
 
         connect(btnWater, &QPushButton::clicked, this, [this]() {
-            for (Plant& p : plants) p.hydration = 1.0f;
-            log("Watered all plants.");
+            GardenTimeline::apply(plants, GardenAction::Water);
+            timeline.record(plants, GardenAction::Water);
+            log(QString("Watered all plants on day %1.").arg(currentDay), LogWater);
+            events.record(GardenEventKind::Manual, 0, "Water", QString("%1 plants, day %2").arg(plants.size()).arg(currentDay));
         });
         connect(btnFeed, &QPushButton::clicked, this, [this]() {
-            for (Plant& p : plants) p.nutrients = 1.0f;
-            log("Fed all plants.");
+            GardenTimeline::apply(plants, GardenAction::Feed);
+            timeline.record(plants, GardenAction::Feed);
+            log(QString("Fed all plants on day %1.").arg(currentDay), LogFeed);
+            events.record(GardenEventKind::Manual, 0, "Feed", QString("%1 plants, day %2").arg(plants.size()).arg(currentDay));
+        });
+        connect(btnSTS, &QPushButton::clicked, this, [this]() {
+            if (!requireSelection(1)) return;
+            for (int i : glWidget->selectedPlants()) {
+                QString why;
+                if (applySTS(plants[i], &why))
+                    log("Applied STS to " + plants[i].genome.strain + ", it will now throw feminized pollen.", LogSTS, i);
+                else
+                    log(why, LogSTS, i, LogSeverity::Warning);
+            }
+            glWidget->update();
+        });
+        connect(btnClone, &QPushButton::clicked, this, [this]() {
+            if (!requireSelection(1)) return;
+            for (int i : glWidget->selectedPlants()) {
+                Plant clone;
+                QString why;
+                if (clonePlant(plants[i], clone, *QRandomGenerator::global(), &why)) {
+                    plants.append(clone);
+                    log("Took a rooted cutting from " + clone.genome.strain + ".", LogClone, i);
+                } else {
+                    log(why, LogClone, i, LogSeverity::Warning);
+                }
+            }
+            gardenChanged();
+        });
+        connect(btnBreed, &QPushButton::clicked, this, [this]() {
+            // First pick is the mother; the second (or the mother herself) gives pollen
+            if (!requireSelection(1)) return;
+            const QList<int>& sel = glWidget->selectedPlants();
+            const Plant& mother = plants[sel[0]];
+            const Plant& donor = plants[sel.value(1, sel[0])];
+            QVector<Plant> seeds;
+            QString why;
+            if (!breedPlants(mother, donor, 12, seeds, *QRandomGenerator::global(), &why)) {
+                log(why, LogBreed, sel[0], LogSeverity::Warning);
+                return;
+            }
+            for (const Plant& seed : seeds) plants.append(seed);
+            log(QString("Bred %1: planted %2 seeds.").arg(seeds.first().genome.strain).arg(seeds.size()), LogBreed, sel[0]);
+            gardenChanged();
+        });
+        connect(btnEvolve, &QPushButton::clicked, this, [this, btnEvolve]() {
+            if (plants.isEmpty()) return;
+            // Founders are the selection, or the whole garden
+            QVector<PackedGenome> founders;
+            QList<int> sel = glWidget->selectedPlants();
+            for (int i = 0; i < plants.size(); ++i)
+                if (sel.isEmpty() || sel.contains(i)) founders << packGenome(plants[i].genome);
+            // The garden can change while the selection runs
+            const PlantGenome parent = plants[sel.value(0, 0)].genome;
+
+            SelectionConfig config;
+            config.seed = QRandomGenerator::global()->generate64();
+            QElapsedTimer clock;
+            clock.start();
+            btnEvolve->setEnabled(false);
+            log(QString("Evolving %1 plants over %2 generations...").arg(config.population).arg(config.generations), LogEvolve);
+
+            // Seconds of work: off the GUI thread, picked up when it finishes
+            auto* watcher = new QFutureWatcher<SelectionResult>(this);
+            connect(watcher, &QFutureWatcher<SelectionResult>::finished, this, [=]() {
+                const SelectionResult result = watcher->result();
+                watcher->deleteLater();
+                btnEvolve->setEnabled(true);
+
+                const GenerationStats& last = result.history.last();
+                log(QString("Selected %1 plants over %2 generations in %3 ms: best fitness %4, mean %5, trait spread %6")
+                    .arg(config.population).arg(config.generations).arg(clock.elapsed())
+                    .arg(last.bestFitness, 0, 'f', 2).arg(last.meanFitness, 0, 'f', 2).arg(last.traitSpread, 0, 'f', 3), LogEvolve);
+
+                Plant p;
+                p.genome = parent;
+                p.genome.strain += QString(" F%1").arg(config.generations);
+                p.genome.wasSTSConverted = false;
+                unpackGenome(result.best, p.genome);
+                p.seed = QRandomGenerator::global()->generate();
+                plants.append(p);
+                gardenChanged();
+            });
+            watcher->setFuture(QtConcurrent::run([founders, config]() { return runSelection(founders, config); }));
         });
         connect(daySlider, &QSlider::valueChanged, this, [this](int val) {
-            currentDay = val;
-            for (Plant& p : plants) {
-                p.age = val;
-                float growthStress = 0.0f;
-                if (p.hydration < 0.5f) growthStress += 0.2f;
-                if (p.nutrients < 0.5f) growthStress += 0.2f;
-                if (QRandomGenerator::global()->generateDouble() < p.genome.hermieChance * growthStress)
-                    p.isHermie = true;
+            timeline.seek(plants, val);
+            currentDay = timeline.currentDay();
+            // Days before the timeline's first can't be reached
+            if (currentDay != val) {
+                QSignalBlocker blocker(daySlider);
+                daySlider->setValue(currentDay);
             }
             glWidget->update();
         });
-        connect(btnSave, &QPushButton::clicked, this, &MainWindow::savePlant);
-        connect(btnLoad, &QPushButton::clicked, this, &MainWindow::loadPlant);
+        connect(checkpointSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int days) {
+            timeline.setCheckpointInterval(days);
+        });
+        connect(btnSave, &QPushButton::clicked, this, &MainWindow::saveGardenAs);
+        connect(btnLoad, &QPushButton::clicked, this, &MainWindow::openGarden);
+    }
+
+    // Plants were added or replaced: history restarts from today
+    void gardenChanged() {
+        timeline.reset(plants, currentDay);
+        glWidget->update();
     }
 
-    void log(const QString& text) {
-        console->append(QDateTime::currentDateTime().toString("hh:mm:ss ") + text);
+    bool requireSelection(int count) {
+        if (glWidget->selectedPlants().size() >= count) return true;
+        log("Select a plant in the garden view first (Ctrl-click to pick more).", LogGeneral, -1, LogSeverity::Warning);
+        return false;
     }
 
-    void savePlant() {
-        QString file = QFileDialog::getSaveFileName(this, "Save Plant", "plant.json");
+    void log(const QString& text, LogCode code = LogGeneral, int plant = -1, LogSeverity severity = LogSeverity::Info) {
+        console->append(severity, plant, code, text);
+    }
+
+    void saveGardenAs() {
+        QString selectedFilter;
+        QString file = QFileDialog::getSaveFileName(this, "Save Garden", "garden.json",
+                                                    "Garden JSON (*.json);;Garden binary (*.garden)", &selectedFilter);
         if (file.isEmpty()) return;
-        QJsonObject obj;
-        obj["strain"] = plants[0].genome.strain;
-        obj["age"] = plants[0].age;
-        obj["wasSTS"] = plants[0].genome.wasSTSConverted;
-        obj["sativaRatio"] = plants[0].genome.sativaRatio;
-        QJsonDocument doc(obj);
-        QFile f(file);
-        if (f.open(QFile::WriteOnly)) {
-            f.write(doc.toJson());
-            f.close();
-            log("Saved plant to " + file);
-        }
+        GardenFormat format = (file.endsWith(".garden") || selectedFilter.contains("binary"))
+            ? GardenFormat::Binary : GardenFormat::Json;
+        QElapsedTimer clock;
+        clock.start();
+        QString error;
+        if (saveGarden(file, plants, format, &error))
+            log(QString("Saved %1 plants to %2 in %3 ms").arg(plants.size()).arg(file).arg(clock.elapsed()), LogFile);
+        else
+            log("Save failed: " + error, LogFile, -1, LogSeverity::Error);
     }
 
-    void loadPlant() {
-        QString file = QFileDialog::getOpenFileName(this, "Load Plant", "plant.json");
+    void openGarden() {
+        QString file = QFileDialog::getOpenFileName(this, "Load Garden", QString(),
+                                                    "Gardens (*.json *.garden);;All files (*)");
         if (file.isEmpty()) return;
-        QFile f(file);
-        if (f.open(QFile::ReadOnly)) {
-            QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
-            f.close();
-            QJsonObject obj = doc.object();
-            Plant p;
-            p.genome.strain = obj["strain"].toString();
-            p.age = obj["age"].toInt();
-            p.genome.wasSTSConverted = obj["wasSTS"].toBool();
-            p.genome.sativaRatio = obj["sativaRatio"].toDouble();
-            plants.append(p);
-            log("Loaded plant: " + p.genome.strain);
-            glWidget->update();
+        QElapsedTimer clock;
+        clock.start();
+        QString error;
+        if (!loadGarden(file, plants, &error)) {
+            log("Load failed: " + error, LogFile, -1, LogSeverity::Error);
+            return;
         }
+        log(QString("Loaded %1 plants from %2 in %3 ms").arg(plants.size()).arg(file).arg(clock.elapsed()), LogFile);
+        glWidget->clearSelection();
+        glWidget->fitToView();
+        gardenChanged();
     }
 };
 
@@ -0,0 +1,327 @@
+#include "plantglwidget.h"
+
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QKeyEvent>
+#include <QtMath>
+
+namespace {
+// World layout, in unscaled pixels
+const float CellWidth = 120.0f;
+const float CellHeight = 420.0f;
+const float MarginX = 50.0f;
+const float SideReach = 160.0f; // branches spread this far either side of the stem
+const float TopReach = 480.0f;  // tallest stem + branches + label
+
+// On-screen sizes at which a plant drops to the next detail level
+const float FullDetailPx = 90.0f;
+const float ImpostorPx = 18.0f;
+const float PointCellPx = 4.0f;
+const float ImpostorScale = 0.3f;
+
+const qreal MinZoom = 0.002;
+const qreal MaxZoom = 4.0;
+}
+
+PlantGLWidget::PlantGLWidget(QList<Plant>* p, QWidget* parent) : QOpenGLWidget(parent), plants(p) {
+    impostors.setMaxCost(48 * 1024 * 1024); // bytes of pixmap data
+    morphologies.setMaxCost(2 * 1024 * 1024); // grammar nodes
+    setFocusPolicy(Qt::StrongFocus);
+    setMouseTracking(false);
+}
+
+int PlantGLWidget::columns() const {
+    return qMax(1, qCeil(qSqrt(plants->size())));
+}
+
+int PlantGLWidget::rows() const {
+    int cols = columns();
+    return (plants->size() + cols - 1) / cols;
+}
+
+QPointF PlantGLWidget::plantBase(int index) const {
+    int cols = columns();
+    return QPointF(MarginX + (index % cols) * CellWidth, (index / cols + 1) * CellHeight - 20);
+}
+
+QRectF PlantGLWidget::visibleWorldRect() const {
+    return QRectF(pan, QSizeF(width() / zoom, height() / zoom));
+}
+
+int PlantGLWidget::plantAt(const QPointF& pos) const {
+    QPointF world = pan + pos / zoom;
+    int col = qFloor((world.x() - MarginX - 3 + CellWidth / 2) / CellWidth);
+    int row = qFloor((world.y() + 20) / CellHeight);
+    int cols = columns();
+    if (col < 0 || col >= cols || row < 0) return -1;
+    int index = row * cols + col;
+    return index < plants->size() ? index : -1;
+}
+
+void PlantGLWidget::clearSelection() {
+    selection.clear();
+    update();
+}
+
+void PlantGLWidget::fitToView() {
+    float worldW = 2 * MarginX + columns() * CellWidth;
+    float worldH = qMax(1, rows()) * CellHeight;
+    qreal fit = qMin(width() / qreal(worldW), height() / qreal(worldH));
+    zoom = qBound(MinZoom, qMin(qreal(1.0), fit), MaxZoom);
+    // Bottom-align so a small garden sits on the ground like before
+    pan = QPointF(0, worldH - height() / zoom);
+    viewMoved = false;
+    update();
+}
+
+void PlantGLWidget::zoomAt(const QPointF& pos, qreal factor) {
+    QPointF world = pan + pos / zoom;
+    zoom = qBound(MinZoom, zoom * factor, MaxZoom);
+    pan = world - pos / zoom;
+    viewMoved = true;
+    update();
+}
+
+QColor PlantGLWidget::plantColor(const Plant& plant) const {
+    return QColor(
+        plant.genome.startColor.red()   + (plant.genome.endColor.red()   - plant.genome.startColor.red()) * (plant.age / 90.0f),
+        plant.genome.startColor.green() + (plant.genome.endColor.green() - plant.genome.startColor.green()) * (plant.age / 90.0f),
+        plant.genome.startColor.blue()  + (plant.genome.endColor.blue()  - plant.genome.startColor.blue()) * (plant.age / 90.0f)
+    );
+}
+
+float PlantGLWidget::stemHeight(const Plant& plant) const {
+    return stemHeightAt(plant.genome, plant.age);
+}
+
+PlantMorphology* PlantGLWidget::morphologyFor(const Plant& plant) {
+    quint32 hash = PlantMorphology::hashGenome(plant.genome);
+    PlantMorphology* morph = morphologies.object(plant.seed);
+    if (!morph || morph->fingerprint() != hash) {
+        morph = new PlantMorphology(plant.genome, plant.seed);
+        morph->grow(plant.age);
+        morphologies.insert(plant.seed, morph, qMax(1, morph->nodeCount()));
+        morph = morphologies.object(plant.seed);
+    }
+    return morph;
+}
+
+PlantGLWidget::Lod PlantGLWidget::lodFor(const Plant& plant) const {
+    float screenHeight = (stemHeight(plant) + SideReach) * zoom;
+    if (screenHeight >= FullDetailPx) return LodFull;
+    if (screenHeight >= ImpostorPx) return LodImpostor;
+    return LodSilhouette;
+}
+
+void PlantGLWidget::drawPlant(QPainter& painter, const Plant& plant, QPointF base) {
+    PlantMorphology* morph = morphologyFor(plant);
+    if (!morph) return;
+    const PlantGeometry& geo = morph->geometry(plant.age);
+    static const float stemWidths[3] = { 4.0f, 1.6f, 0.8f };
+
+    painter.save();
+    painter.translate(base + QPointF(3, 0));
+
+    QColor interpColor = plantColor(plant);
+    QPen pen(interpColor);
+    pen.setCapStyle(Qt::RoundCap);
+    for (int order = 0; order < 3; ++order) {
+        pen.setWidthF(stemWidths[order]);
+        painter.setPen(pen);
+        painter.drawLines(geo.stems[order]);
+    }
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(interpColor.darker(140));
+    painter.drawPath(geo.leaves);
+    painter.setBrush(plant.isHermie ? QColor(Qt::yellow) : QColor(Qt::magenta));
+    painter.drawPath(geo.buds);
+
+    painter.restore();
+}
+
+void PlantGLWidget::drawSilhouette(QPainter& painter, const Plant& plant, QPointF base) {
+    float stem = stemHeight(plant);
+    float spread = qMin(stem * 0.45f, SideReach * 0.6f);
+    QPointF canopy[3] = {
+        QPointF(base.x() + 3, base.y() - stem - 8),
+        QPointF(base.x() + 3 - spread, base.y() - stem * 0.15f),
+        QPointF(base.x() + 3 + spread, base.y() - stem * 0.15f)
+    };
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(plantColor(plant));
+    painter.drawPolygon(canopy, 3);
+    if (plant.isHermie) {
+        painter.setBrush(Qt::magenta);
+        painter.drawEllipse(canopy[0], 6, 6);
+    }
+}
+
+void PlantGLWidget::drawImpostor(QPainter& painter, const Plant& plant, QPointF base) {
+    // Everything that changes the drawing is in the key
+    quint32 shape = plant.seed ^ PlantMorphology::hashGenome(plant.genome);
+    quint64 key = (quint64(shape) << 32) | (quint64(plant.age & 0x7fff) << 1) | (plant.isHermie ? 1 : 0);
+    QRectF local(-SideReach, -(stemHeight(plant) + SideReach), 2 * SideReach + 6, stemHeight(plant) + SideReach + 8);
+
+    QPixmap pix;
+    if (QPixmap* cached = impostors.object(key)) {
+        pix = *cached;
+    } else {
+        pix = QPixmap((local.size() * ImpostorScale).toSize().expandedTo(QSize(1, 1)));
+        pix.fill(Qt::transparent);
+        QPainter p(&pix);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.scale(ImpostorScale, ImpostorScale);
+        p.translate(-local.topLeft());
+        drawPlant(p, plant, QPointF(0, 0));
+        p.end();
+        impostors.insert(key, new QPixmap(pix), pix.width() * pix.height() * 4);
+    }
+    painter.drawPixmap(local.translated(base), pix, QRectF(pix.rect()));
+}
+
+void PlantGLWidget::paintEvent(QPaintEvent*) {
+    frameClock.start();
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+    if (plants->isEmpty()) return;
+
+    // Only visit grid cells whose plant bounds can reach the viewport
+    QRectF view = visibleWorldRect();
+    int cols = columns();
+    int firstCol = qMax(0, qFloor((view.left() - 6 - SideReach - MarginX) / CellWidth));
+    int lastCol = qMin(cols - 1, qCeil((view.right() + SideReach - MarginX) / CellWidth));
+    int firstRow = qMax(0, qFloor((view.top() + 15) / CellHeight) - 1);
+    int lastRow = qMin(rows() - 1, qCeil((view.bottom() + TopReach + 20) / CellHeight) - 1);
+
+    painter.scale(zoom, zoom);
+    painter.translate(-pan);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    bool pointsOnly = CellWidth * zoom < PointCellPx;
+    bool labels = zoom >= 0.6;
+    QVector<QPointF> points, hermiePoints;
+    int drawn = 0;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int col = firstCol; col <= lastCol; ++col) {
+            int index = row * cols + col;
+            if (index >= plants->size()) break;
+            const Plant& plant = plants->at(index);
+            QPointF base = plantBase(index);
+            drawn++;
+
+            if (!pointsOnly && selection.contains(index)) {
+                QPen outline(selection.first() == index ? Qt::cyan : Qt::yellow);
+                outline.setCosmetic(true);
+                painter.setPen(outline);
+                painter.setBrush(Qt::NoBrush);
+                painter.drawRect(QRectF(base.x() + 3 - CellWidth / 2, base.y() - CellHeight + 20, CellWidth, CellHeight));
+            }
+
+            const Lod lod = pointsOnly ? LodPoint : lodFor(plant);
+            switch (lod) {
+            case LodFull:
+                drawPlant(painter, plant, base);
+                break;
+            case LodImpostor:
+                drawImpostor(painter, plant, base);
+                break;
+            case LodSilhouette:
+                drawSilhouette(painter, plant, base);
+                break;
+            case LodPoint:
+                (plant.isHermie ? hermiePoints : points).append(base + QPointF(3, -stemHeight(plant) * 0.5f));
+                continue;
+            }
+
+            if (labels) {
+                // Draw label
+                QString label = QString("%1 (%2d)%3")
+                    .arg(plant.genome.strain)
+                    .arg(plant.age)
+                    .arg(plant.isHermie ? " H" : "");
+                painter.setPen(Qt::white);
+                painter.drawText(QPointF(base.x() - 10, base.y() - stemHeight(plant) - 10), label);
+            }
+        }
+    }
+
+    if (!points.isEmpty() || !hermiePoints.isEmpty()) {
+        QPen pen(Qt::darkGreen);
+        pen.setCosmetic(true);
+        pen.setWidthF(2);
+        painter.setPen(pen);
+        painter.drawPoints(points.constData(), points.size());
+        pen.setColor(Qt::magenta);
+        painter.setPen(pen);
+        painter.drawPoints(hermiePoints.constData(), hermiePoints.size());
+    }
+
+    painter.resetTransform();
+    painter.setPen(Qt::gray);
+    painter.drawText(rect().adjusted(6, 4, -6, -4), Qt::AlignTop | Qt::AlignRight,
+                     QString("%1/%2 plants  %3x  %4 ms")
+                         .arg(drawn).arg(plants->size())
+                         .arg(zoom, 0, 'f', 2).arg(frameMs, 0, 'f', 1));
+    frameMs = frameClock.nsecsElapsed() / 1e6f;
+}
+
+void PlantGLWidget::resizeEvent(QResizeEvent* e) {
+    QOpenGLWidget::resizeEvent(e);
+    if (!viewMoved) fitToView();
+}
+
+void PlantGLWidget::wheelEvent(QWheelEvent* e) {
+    zoomAt(e->pos(), qPow(1.0015, e->angleDelta().y()));
+}
+
+void PlantGLWidget::mousePressEvent(QMouseEvent* e) {
+    if (e->button() == Qt::LeftButton) {
+        dragging = true;
+        lastMousePos = e->pos();
+        pressPos = e->pos();
+    }
+}
+
+void PlantGLWidget::mouseMoveEvent(QMouseEvent* e) {
+    if (!dragging) return;
+    pan -= QPointF(e->pos() - lastMousePos) / zoom;
+    lastMousePos = e->pos();
+    viewMoved = true;
+    update();
+}
+
+void PlantGLWidget::mouseReleaseEvent(QMouseEvent* e) {
+    dragging = false;
+    if (e->button() != Qt::LeftButton || (e->pos() - pressPos).manhattanLength() > 3) return;
+
+    // A click rather than a drag: pick the plant under the cursor
+    int index = plantAt(e->pos());
+    if (!(e->modifiers() & Qt::ControlModifier)) selection.clear();
+    if (index >= 0 && !selection.removeOne(index)) selection.append(index);
+    update();
+}
+
+void PlantGLWidget::mouseDoubleClickEvent(QMouseEvent*) {
+    fitToView();
+}
+
+void PlantGLWidget::keyPressEvent(QKeyEvent* e) {
+    const qreal step = 60.0 / zoom;
+    switch (e->key()) {
+    case Qt::Key_Left:  pan.rx() -= step; break;
+    case Qt::Key_Right: pan.rx() += step; break;
+    case Qt::Key_Up:    pan.ry() -= step; break;
+    case Qt::Key_Down:  pan.ry() += step; break;
+    case Qt::Key_Plus:
+    case Qt::Key_Equal: zoomAt(rect().center(), 1.25); return;
+    case Qt::Key_Minus: zoomAt(rect().center(), 0.8); return;
+    case Qt::Key_Home:  fitToView(); return;
+    default:
+        QOpenGLWidget::keyPressEvent(e);
+        return;
+    }
+    viewMoved = true;
+    update();
+}
@@ -0,0 +1,77 @@
+#ifndef PLANTGLWIDGET_H
+#define PLANTGLWIDGET_H
+
+#include <QOpenGLWidget>
+#include <QPainter>
+#include <QPixmap>
+#include <QCache>
+#include <QElapsedTimer>
+
+#include "plant.h"
+#include "lsystem.h"
+
+// Garden view. Plants are laid out on a grid in world units and viewed through
+// a pan/zoom camera (drag to scroll, wheel to zoom, double-click to fit).
+// Only grid cells that intersect the viewport are visited, and each plant is
+// drawn at a level of detail picked from its on-screen size.
+class PlantGLWidget : public QOpenGLWidget {
+public:
+    QList<Plant>* plants;
+    PlantGLWidget(QList<Plant>* p, QWidget* parent = nullptr);
+
+    void fitToView();
+
+    // Click to select a plant, Ctrl-click to add more. Order is kept, so the
+    // first pick can be treated as the mother when breeding.
+    const QList<int>& selectedPlants() const { return selection; }
+    void clearSelection();
+
+protected:
+    void paintEvent(QPaintEvent*) override;
+    void resizeEvent(QResizeEvent* e) override;
+    void wheelEvent(QWheelEvent* e) override;
+    void mousePressEvent(QMouseEvent* e) override;
+    void mouseMoveEvent(QMouseEvent* e) override;
+    void mouseReleaseEvent(QMouseEvent* e) override;
+    void mouseDoubleClickEvent(QMouseEvent* e) override;
+    void keyPressEvent(QKeyEvent* e) override;
+
+private:
+    enum Lod {
+        LodFull,       // every branch, leaf and bud
+        LodImpostor,   // cached pixmap of the full plant, scaled
+        LodSilhouette, // stem + canopy triangle
+        LodPoint       // one batched point per plant
+    };
+
+    int columns() const;
+    int rows() const;
+    QPointF plantBase(int index) const;
+    QRectF visibleWorldRect() const;
+    int plantAt(const QPointF& pos) const;
+    void zoomAt(const QPointF& pos, qreal factor);
+
+    QColor plantColor(const Plant& plant) const;
+    float stemHeight(const Plant& plant) const;
+    // Detail for one plant at the current zoom, short of LodPoint (which is
+    // decided for the whole view)
+    Lod lodFor(const Plant& plant) const;
+    PlantMorphology* morphologyFor(const Plant& plant);
+    void drawPlant(QPainter& painter, const Plant& plant, QPointF base);
+    void drawSilhouette(QPainter& painter, const Plant& plant, QPointF base);
+    void drawImpostor(QPainter& painter, const Plant& plant, QPointF base);
+
+    QCache<quint64, QPixmap> impostors;
+    QCache<quint32, PlantMorphology> morphologies; // by plant seed
+    QPointF pan;       // world position of the widget's top-left corner
+    qreal zoom = 1.0;
+    bool viewMoved = false;
+    bool dragging = false;
+    QPoint lastMousePos;
+    QPoint pressPos;
+    QList<int> selection;
+    QElapsedTimer frameClock;
+    float frameMs = 0.0f;
+};
+
+#endif // PLANTGLWIDGET_H
@@ -1,5 +1,6 @@
 QT       += core gui
 QT += multimedia\
+        concurrent\
         sql
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
@@ -18,9 +19,35 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    main.cpp
+    main.cpp \
+    audiomixer.cpp \
+    audiooutput.cpp \
+    batchitem.cpp \
+    collision.cpp \
+    director.cpp \
+    entities.cpp \
+    headless.cpp \
+    particles.cpp \
+    perfoverlay.cpp \
+    replay.cpp \
+    spriteatlas.cpp \
+    world.cpp
 
 HEADERS += \
+    audiomixer.h \
+    audiooutput.h \
+    batchitem.h \
+    collision.h \
+    director.h \
+    entities.h \
+    headless.h \
+    input.h \
+    itempool.h \
+    particles.h \
+    perfoverlay.h \
+    replay.h \
+    spriteatlas.h \
+    world.h
 
 FORMS += \
 
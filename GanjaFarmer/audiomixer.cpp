@@ -0,0 +1,178 @@
+#include "audiomixer.h"
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+const char* SoundPaths[SoundCount] = {
+    ":/assets/sounds/shoot.wav",
+    ":/assets/sounds/explosion.wav",
+    ":/assets/sounds/failure.wav",
+};
+
+quint16 le16(const char* p) { return qFromLittleEndian<quint16>(p); }
+quint32 le32(const char* p) { return qFromLittleEndian<quint32>(p); }
+}
+
+bool decodeWav(const QByteArray& wav, SoundClip& clip, QString* error) {
+    if (wav.size() < 12 || !wav.startsWith("RIFF") || wav.mid(8, 4) != "WAVE") {
+        if (error) *error = "not a RIFF/WAVE file";
+        return false;
+    }
+
+    int channels = 0, rate = 0, bits = 0;
+    const char* pcm = nullptr;
+    int pcmBytes = 0;
+    for (int pos = 12; pos + 8 <= wav.size();) {
+        const char* chunk = wav.constData() + pos;
+        int size = int(le32(chunk + 4));
+        if (size < 0 || pos + 8 + size > wav.size()) size = wav.size() - pos - 8;
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            quint16 format = le16(chunk + 8);
+            channels = le16(chunk + 10);
+            rate = int(le32(chunk + 12));
+            bits = le16(chunk + 22);
+            if (format != 1 && format != 0xFFFE) {
+                if (error) *error = "only uncompressed PCM is supported";
+                return false;
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            pcm = chunk + 8;
+            pcmBytes = size;
+        }
+        pos += 8 + size + (size & 1);   // chunks are word aligned
+    }
+    if (!pcm || channels < 1 || rate <= 0 || bits != 16) {
+        if (error) *error = "expected 16-bit PCM with fmt and data chunks";
+        return false;
+    }
+
+    // Linear resample to MixRate; mono is copied to both sides, extra channels dropped
+    int inFrames = pcmBytes / (2 * channels);
+    int outFrames = int(qint64(inFrames) * MixRate / rate);
+    clip.samples.resize(outFrames * MixChannels);
+    const char* data = pcm;
+    auto sample = [&](int frame, int channel) {
+        return float(qint16(le16(data + 2 * (frame * channels + qMin(channel, channels - 1)))));
+    };
+    for (int i = 0; i < outFrames; ++i) {
+        double src = double(i) * rate / MixRate;
+        int f0 = int(src);
+        int f1 = qMin(f0 + 1, inFrames - 1);
+        float t = float(src - f0);
+        for (int c = 0; c < MixChannels; ++c)
+            clip.samples[i * MixChannels + c] = qint16(sample(f0, c) * (1 - t) + sample(f1, c) * t);
+    }
+    return true;
+}
+
+AudioMixer::AudioMixer(int voiceCount, int voicesPerSound) : perSound(voicesPerSound) {
+    voices.resize(voiceCount);
+    clock.start();
+}
+
+bool AudioMixer::load(QString* error) {
+    for (int s = 0; s < SoundCount; ++s) {
+        QFile file(SoundPaths[s]);
+        QString why;
+        if (!file.open(QIODevice::ReadOnly)) why = file.errorString();
+        else decodeWav(file.readAll(), clips[s], &why);
+        if (!why.isEmpty()) {
+            if (error) *error = QString("%1: %2").arg(SoundPaths[s]).arg(why);
+            return false;
+        }
+    }
+    return true;
+}
+
+void AudioMixer::play(Sound sound, float volume) {
+    QMutexLocker locker(&lock);
+    if (clips[sound].frames() == 0) return;
+
+    // Reuse, in order of preference: the oldest voice of this sound if it is
+    // at its limit, a free voice, or the oldest voice of all
+    int same = 0, oldestSame = -1, oldest = -1, idle = -1;
+    for (int i = 0; i < voices.size(); ++i) {
+        const Voice& v = voices[i];
+        if (v.sound < 0) {
+            if (idle < 0) idle = i;
+            continue;
+        }
+        if (v.sound == sound) {
+            same++;
+            if (oldestSame < 0 || v.order < voices[oldestSame].order) oldestSame = i;
+        }
+        if (oldest < 0 || v.order < voices[oldest].order) oldest = i;
+    }
+    int slot = same >= perSound ? oldestSame : idle >= 0 ? idle : oldest;
+    if (slot < 0) return;
+    if (voices[slot].sound >= 0) counters.stolen++;
+
+    Voice& v = voices[slot];
+    v.sound = sound;
+    v.position = 0;
+    v.volume = volume;
+    v.order = nextOrder++;
+    v.triggeredNs = clock.nsecsElapsed();
+    v.started = false;
+    counters.played++;
+}
+
+void AudioMixer::mix(qint16* out, int frames) {
+    QMutexLocker locker(&lock);
+    int samples = frames * MixChannels;
+    if (accumulator.size() < samples) accumulator.resize(samples);
+    qint32* acc = accumulator.data();
+    std::fill(acc, acc + samples, 0);
+
+    qint64 now = clock.nsecsElapsed();
+    int active = 0;
+    for (Voice& v : voices) {
+        if (v.sound < 0) continue;
+        if (!v.started) {
+            v.started = true;
+            double ms = (now - v.triggeredNs + outputDelayNs) / 1e6;
+            counters.lastLatencyMs = ms;
+            counters.maxLatencyMs = qMax(counters.maxLatencyMs, ms);
+            latencySumMs += ms;
+            latencySamples++;
+        }
+        const SoundClip& clip = clips[v.sound];
+        int n = qMin(frames, clip.frames() - v.position) * MixChannels;
+        const qint16* src = clip.samples.constData() + v.position * MixChannels;
+        // Volume in 8.8 fixed point keeps the inner loop integer-only
+        qint32 gain = qint32(v.volume * 256);
+        for (int i = 0; i < n; ++i)
+            acc[i] += (src[i] * gain) >> 8;
+        v.position += n / MixChannels;
+        if (v.position >= clip.frames()) v.sound = -1;
+        else active++;
+    }
+    counters.active = active;
+
+    for (int i = 0; i < samples; ++i)
+        out[i] = qint16(qBound(-32768, acc[i], 32767));
+}
+
+void AudioMixer::setOutputDelay(qint64 ns) {
+    QMutexLocker locker(&lock);
+    outputDelayNs = ns;
+}
+
+AudioMixer::Stats AudioMixer::stats() const {
+    QMutexLocker locker(&lock);
+    Stats s = counters;
+    s.meanLatencyMs = latencySamples ? latencySumMs / latencySamples : 0;
+    return s;
+}
+
+void NullSink::pump(double seconds) {
+    pending += seconds * MixRate;
+    int frames = int(pending);
+    if (frames <= 0) return;
+    pending -= frames;
+    if (scratch.size() < frames * MixChannels) scratch.resize(frames * MixChannels);
+    mixer->mix(scratch.data(), frames);
+}
@@ -0,0 +1,96 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+enum Sound {
+    SoundShoot,
+    SoundExplosion,
+    SoundFailure,
+    SoundCount
+};
+
+// Everything is mixed as interleaved 16-bit stereo at one rate; clips are
+// converted to it when they are loaded, never while playing.
+const int MixRate = 48000;
+const int MixChannels = 2;
+
+struct SoundClip {
+    QVector<qint16> samples;   // interleaved, MixChannels per frame
+    int frames() const { return samples.size() / MixChannels; }
+};
+
+// Reads a PCM 16-bit WAV of any rate and channel count into mixer format
+bool decodeWav(const QByteArray& wav, SoundClip& clip, QString* error);
+
+// A small software mixer: a fixed set of voices, each playing one clip from
+// memory. When a sound already has its maximum voices, or every voice is
+// busy, the oldest one is cut and reused, so rapid fire never drops the
+// newest shot. play() can be called from the game thread while an audio
+// backend pulls mix() from its own.
+class AudioMixer {
+public:
+    explicit AudioMixer(int voices = 16, int voicesPerSound = 4);
+
+    // Decodes the effects from the resources; false if any of them failed
+    bool load(QString* error);
+
+    void play(Sound sound, float volume = 1.0f);
+    void mix(qint16* out, int frames);
+
+    // How far ahead of the speaker the backend has queued audio, so
+    // latency can include it; a null sink leaves it at 0
+    void setOutputDelay(qint64 ns);
+
+    struct Stats {
+        double lastLatencyMs = 0;   // play() to first mixed sample, plus queued output
+        double meanLatencyMs = 0;
+        double maxLatencyMs = 0;
+        int played = 0;
+        int stolen = 0;
+        int active = 0;
+    };
+    Stats stats() const;
+
+private:
+    struct Voice {
+        int sound = -1;        // -1 when free
+        int position = 0;      // next frame to mix
+        float volume = 1;
+        quint64 order = 0;     // higher started later
+        qint64 triggeredNs = 0;
+        bool started = false;
+    };
+
+    SoundClip clips[SoundCount];
+    QVector<Voice> voices;
+    QVector<qint32> accumulator;   // reused across mix() calls
+    int perSound;
+    quint64 nextOrder = 0;
+    qint64 outputDelayNs = 0;
+    double latencySumMs = 0;
+    int latencySamples = 0;
+    Stats counters;
+    QElapsedTimer clock;
+    mutable QMutex lock;
+};
+
+// Stands in for an audio device when there is none, or no display at all:
+// mixes the same amount of audio real time would have, then drops it.
+class NullSink {
+public:
+    explicit NullSink(AudioMixer* mixer) : mixer(mixer) {}
+
+    void pump(double seconds);
+
+private:
+    AudioMixer* mixer;
+    double pending = 0;         // fractional frames carried to the next pump
+    QVector<qint16> scratch;
+};
+
+#endif // AUDIOMIXER_H
@@ -0,0 +1,73 @@
+#include "audiooutput.h"
+
+#include <QAudioDeviceInfo>
+
+namespace {
+const int BytesPerFrame = MixChannels * sizeof(qint16);
+}
+
+// Hands QAudioOutput freshly mixed audio whenever it asks for more
+class AudioOutput::Device : public QIODevice {
+public:
+    Device(AudioMixer* mixer, QAudioOutput** output) : mixer(mixer), output(output) {}
+
+    qint64 bytesAvailable() const override { return 1 << 20; }  // a live stream never runs dry
+
+protected:
+    qint64 readData(char* data, qint64 maxlen) override {
+        int frames = int(maxlen / BytesPerFrame);
+        if (*output) {
+            // Whatever is already queued plays before this block
+            qint64 queued = (*output)->bufferSize() - (*output)->bytesFree();
+            mixer->setOutputDelay(queued * 1000000000LL / (MixRate * BytesPerFrame));
+        }
+        mixer->mix(reinterpret_cast<qint16*>(data), frames);
+        return qint64(frames) * BytesPerFrame;
+    }
+
+    qint64 writeData(const char*, qint64) override { return -1; }
+
+private:
+    AudioMixer* mixer;
+    QAudioOutput** output;
+};
+
+AudioOutput::AudioOutput(AudioMixer* mixer) : mixer(mixer) {
+}
+
+AudioOutput::~AudioOutput() {
+    if (output) output->stop();
+    delete output;
+    delete device;
+}
+
+bool AudioOutput::start(int ms, QString* error) {
+    QAudioFormat format;
+    format.setSampleRate(MixRate);
+    format.setChannelCount(MixChannels);
+    format.setSampleSize(16);
+    format.setCodec("audio/pcm");
+    format.setByteOrder(QAudioFormat::LittleEndian);
+    format.setSampleType(QAudioFormat::SignedInt);
+
+    QAudioDeviceInfo info = QAudioDeviceInfo::defaultOutputDevice();
+    if (info.isNull() || !info.isFormatSupported(format)) {
+        if (error) *error = info.isNull() ? "no audio output device" : "device does not take 48 kHz 16-bit stereo";
+        return false;
+    }
+
+    device = new Device(mixer, &output);
+    device->open(QIODevice::ReadOnly);
+    output = new QAudioOutput(info, format);
+    output->setBufferSize(MixRate * BytesPerFrame * ms / 1000);
+    output->start(device);
+    if (output->error() != QAudio::NoError) {
+        if (error) *error = QString("audio output failed to start (error %1)").arg(output->error());
+        return false;
+    }
+    return true;
+}
+
+int AudioOutput::bufferMs() const {
+    return output ? int(qint64(output->bufferSize()) * 1000 / (MixRate * BytesPerFrame)) : 0;
+}
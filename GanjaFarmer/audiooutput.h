@@ -0,0 +1,31 @@
+#ifndef AUDIOOUTPUT_H
+#define AUDIOOUTPUT_H
+
+#include <QAudioOutput>
+#include <QIODevice>
+
+#include "audiomixer.h"
+
+// Plays an AudioMixer through one QAudioOutput stream in pull mode, with a
+// short buffer so a triggered sound reaches the speaker within a few
+// milliseconds instead of going through QSoundEffect's per-play pipeline.
+class AudioOutput {
+public:
+    explicit AudioOutput(AudioMixer* mixer);
+    ~AudioOutput();
+
+    // False when there is no device or it can't take the mixer's format;
+    // the caller then drives the mixer with a NullSink instead
+    bool start(int bufferMs, QString* error);
+    // The buffer the device granted, which need not be the one asked for
+    int bufferMs() const;
+
+private:
+    class Device;
+
+    AudioMixer* mixer;
+    Device* device = nullptr;
+    QAudioOutput* output = nullptr;
+};
+
+#endif // AUDIOOUTPUT_H
@@ -0,0 +1,73 @@
+#include "batchitem.h"
+
+namespace {
+const Sprite KindSprite[KindCount] = {
+    SpritePlane,     // KindPlane
+    SpriteHeli,      // KindHeli
+    SpriteTrooper,   // KindFalling
+    SpriteTrooper,   // KindTroop
+    SpriteBullet     // KindBullet
+};
+
+// Draw order, matching the z values of the item path
+const int KindLayer[KindCount] = { 0, 0, 1, 1, 2 };
+const int LayerCount = 3;
+}
+
+BatchItem::BatchItem(const SpriteAtlas* atlas, const GameWorld* world) : atlas(atlas), world(world) {
+    fragments.reserve(1024);
+}
+
+void BatchItem::setFrame(double a) {
+    alpha = a;
+    update();
+}
+
+QRectF BatchItem::boundingRect() const {
+    return QRectF(0, 0, WIDTH, HEIGHT);
+}
+
+void BatchItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*) {
+    if (!atlas->isReady()) return;
+    const EntityStore& es = world->entities();
+    fragments.clear();
+    for (int layer = 0; layer < LayerCount; ++layer) {
+        for (int i = 0; i < es.size(); ++i) {
+            quint8 k = es.kind[i];
+            if (KindLayer[k] != layer) continue;
+            QRect src = atlas->rect(KindSprite[k]);
+            float x = es.prevX[i] + (es.x[i] - es.prevX[i]) * alpha;
+            float y = es.prevY[i] + (es.y[i] - es.prevY[i]) * alpha;
+            // Fragments are placed by their centre; bullets already are
+            if (k != KindBullet) {
+                x += src.width() / 2.0f;
+                y += src.height() / 2.0f;
+            }
+            fragments << QPainter::PixmapFragment::create(QPointF(x, y), src);
+        }
+    }
+    painter->drawPixmapFragments(fragments.constData(), fragments.size(), atlas->sheet());
+    drawn = fragments.size();
+}
+
+ParticleItem::ParticleItem(const SpriteAtlas* atlas, const ParticleSystem* particles)
+    : atlas(atlas), particles(particles) {
+    fragments.reserve(particles->capacity());
+    setZValue(3);
+}
+
+QRectF ParticleItem::boundingRect() const {
+    return QRectF(0, 0, WIDTH, HEIGHT);
+}
+
+void ParticleItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*) {
+    if (!atlas->isReady() || particles->size() == 0) return;
+    const ParticleSystem& ps = *particles;
+    fragments.resize(ps.size());
+    for (int i = 0; i < ps.size(); ++i) {
+        float s = ps.scale[i];
+        fragments[i] = QPainter::PixmapFragment::create(QPointF(ps.x[i], ps.y[i]), atlas->rect(Sprite(ps.sprite[i])),
+                                                        s, s, 0, ps.life[i] / ps.maxLife[i]);
+    }
+    painter->drawPixmapFragments(fragments.constData(), fragments.size(), atlas->sheet());
+}
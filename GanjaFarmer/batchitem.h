@@ -0,0 +1,49 @@
+#ifndef BATCHITEM_H
+#define BATCHITEM_H
+
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QVector>
+
+#include "particles.h"
+#include "spriteatlas.h"
+#include "world.h"
+
+// The alternative to pooled items: one scene item that paints every entity
+// straight from the world's arrays, as a single drawPixmapFragments call on
+// the atlas sheet. The scene index only ever sees this one item.
+class BatchItem : public QGraphicsItem {
+public:
+    BatchItem(const SpriteAtlas* atlas, const GameWorld* world);
+
+    // Blend factor between the last two ticks for the next paint
+    void setFrame(double alpha);
+    int lastDrawCount() const { return drawn; }
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+    const SpriteAtlas* atlas;
+    const GameWorld* world;
+    double alpha = 0;
+    int drawn = 0;
+    QVector<QPainter::PixmapFragment> fragments;   // reused every paint
+};
+
+// Every live particle in one drawPixmapFragments call, fading with age.
+// Drawn in both render modes, above everything else in play.
+class ParticleItem : public QGraphicsItem {
+public:
+    ParticleItem(const SpriteAtlas* atlas, const ParticleSystem* particles);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+    const SpriteAtlas* atlas;
+    const ParticleSystem* particles;
+    QVector<QPainter::PixmapFragment> fragments;
+};
+
+#endif // BATCHITEM_H
@@ -0,0 +1,76 @@
+#include "collision.h"
+
+#include <QtMath>
+#include <algorithm>
+
+CollisionGrid::CollisionGrid(float width, float height, float cellSize)
+    : cellSize(cellSize),
+      cols(qMax(1, qCeil(width / cellSize))),
+      rows(qMax(1, qCeil(height / cellSize))) {
+    cellStart.resize(cols * rows + 1);
+    cursor.resize(cols * rows);
+}
+
+QRect CollisionGrid::cellSpan(const QRectF& box) const {
+    // Anything off the playfield is clamped into the border cells
+    int x0 = qBound(0, int(std::floor(box.left() / cellSize)), cols - 1);
+    int x1 = qBound(0, int(std::floor(box.right() / cellSize)), cols - 1);
+    int y0 = qBound(0, int(std::floor(box.top() / cellSize)), rows - 1);
+    int y1 = qBound(0, int(std::floor(box.bottom() / cellSize)), rows - 1);
+    return QRect(QPoint(x0, y0), QPoint(x1, y1));
+}
+
+void CollisionGrid::clear() {
+    ids.clear();
+    boxes.clear();
+    spans.clear();
+}
+
+void CollisionGrid::add(int id, const QRectF& box) {
+    ids << id;
+    boxes << box;
+    spans << cellSpan(box);
+}
+
+void CollisionGrid::build() {
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (const QRect& s : spans)
+        for (int cy = s.top(); cy <= s.bottom(); ++cy)
+            for (int cx = s.left(); cx <= s.right(); ++cx)
+                cellStart[cy * cols + cx + 1]++;
+    for (int c = 0; c < cols * rows; ++c) {
+        cellStart[c + 1] += cellStart[c];
+        cursor[c] = cellStart[c];
+    }
+    cellEntries.resize(cellStart[cols * rows]);
+    for (int j = 0; j < spans.size(); ++j) {
+        const QRect& s = spans[j];
+        for (int cy = s.top(); cy <= s.bottom(); ++cy)
+            for (int cx = s.left(); cx <= s.right(); ++cx)
+                cellEntries[cursor[cy * cols + cx]++] = j;
+    }
+}
+
+bool segmentHitsBox(const QPointF& a, const QPointF& b, const QRectF& box, float* t) {
+    // Slab method: clip the segment against the x and y extents in turn
+    float t0 = 0, t1 = 1;
+    const float d[2] = { float(b.x() - a.x()), float(b.y() - a.y()) };
+    const float p[2] = { float(a.x()), float(a.y()) };
+    const float lo[2] = { float(box.left()), float(box.top()) };
+    const float hi[2] = { float(box.right()), float(box.bottom()) };
+    for (int axis = 0; axis < 2; ++axis) {
+        if (qFuzzyIsNull(d[axis])) {
+            if (p[axis] < lo[axis] || p[axis] > hi[axis]) return false;
+            continue;
+        }
+        float inv = 1.0f / d[axis];
+        float enter = (lo[axis] - p[axis]) * inv;
+        float leave = (hi[axis] - p[axis]) * inv;
+        if (enter > leave) std::swap(enter, leave);
+        t0 = qMax(t0, enter);
+        t1 = qMin(t1, leave);
+        if (t0 > t1) return false;
+    }
+    if (t) *t = t0;
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+#include <QVector>
+
+// Uniform grid broad phase over the playfield. Boxes are added, then build()
+// buckets them into cells with a counting sort, so the cell lists are one
+// flat array and rebuilding every tick allocates nothing once warmed up.
+// A box spanning several cells is listed in each of them; callers of visit()
+// must tolerate seeing the same id more than once.
+class CollisionGrid {
+public:
+    CollisionGrid(float width, float height, float cellSize);
+
+    void clear();
+    void add(int id, const QRectF& box);
+    void build();
+
+    // Calls f(id, box) for every box in the cells `area` touches
+    template <typename F>
+    void visit(const QRectF& area, F f) const {
+        QRect span = cellSpan(area);
+        for (int cy = span.top(); cy <= span.bottom(); ++cy) {
+            for (int cx = span.left(); cx <= span.right(); ++cx) {
+                int c = cy * cols + cx;
+                for (int k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+                    int j = cellEntries[k];
+                    f(ids[j], boxes[j]);
+                }
+            }
+        }
+    }
+
+private:
+    QRect cellSpan(const QRectF& box) const;
+
+    float cellSize;
+    int cols, rows;
+    QVector<int> ids;
+    QVector<QRectF> boxes;
+    QVector<QRect> spans;       // cells each box covers
+    QVector<int> cellStart;     // cols*rows+1 offsets into cellEntries
+    QVector<int> cellEntries;   // indices into ids/boxes
+    QVector<int> cursor;
+};
+
+// Swept test: does the segment a->b touch `box`? On a hit, *t is where along
+// the segment (0..1) it first enters. Testing a moving point's whole path
+// this way means a fast bullet can't step over a thin target.
+bool segmentHitsBox(const QPointF& a, const QPointF& b, const QRectF& box, float* t);
+
+struct Hit {
+    int bullet;
+    int target;
+    float t;   // time of impact within the tick, for ordering
+};
+
+#endif // COLLISION_H
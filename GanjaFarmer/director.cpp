@@ -0,0 +1,166 @@
+#include "director.h"
+
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+#include "world.h"
+
+namespace {
+const double TroopFallSpeed = 3;   // px per 40 ms
+
+SpawnKind kindFromName(const QString& name, bool* ok) {
+    *ok = true;
+    if (name == "plane") return SpawnPlane;
+    if (name == "heli") return SpawnHeli;
+    if (name == "aircraft") return SpawnAircraft;
+    if (name == "trooper") return SpawnTrooper;
+    *ok = false;
+    return SpawnAircraft;
+}
+
+quint64 secondsToTicks(double s) {
+    return quint64(qMax(0.0, s) / STEP + 0.5);
+}
+}
+
+bool loadWaves(const QString& path, WaveSet& waves, QString* error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    QByteArray data = file.readAll();
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    if (!doc.isObject()) {
+        if (error) *error = parseError.errorString();
+        return false;
+    }
+
+    WaveSet loaded;
+    loaded.checksum = qHash(data, 0);
+    for (const QJsonValue& w : doc.object().value("waves").toArray()) {
+        QJsonObject o = w.toObject();
+        WaveSpec wave;
+        wave.name = o.value("name").toString(QString("Wave %1").arg(loaded.waves.size() + 1));
+        wave.level = o.value("level").toInt(loaded.waves.size() + 1);
+        wave.duration = o.value("duration").toDouble(wave.duration);
+        wave.repeat = o.value("repeat").toBool();
+        if (wave.duration < STEP) {
+            if (error) *error = wave.name + ": duration must be positive";
+            return false;
+        }
+        for (const QJsonValue& g : o.value("spawns").toArray()) {
+            QJsonObject s = g.toObject();
+            SpawnGroup group;
+            bool ok;
+            group.kind = kindFromName(s.value("kind").toString("aircraft"), &ok);
+            if (!ok) {
+                if (error) *error = wave.name + ": unknown kind \"" + s.value("kind").toString() + "\"";
+                return false;
+            }
+            group.count = s.value("count").toInt(group.count);
+            group.start = s.value("start").toDouble(group.start);
+            group.interval = s.value("interval").toDouble(group.interval);
+            group.speed = float(s.value("speed").toDouble(group.speed));
+            group.dropRate = float(s.value("dropRate").toDouble(group.dropRate));
+            QJsonArray altitude = s.value("altitude").toArray();
+            if (altitude.size() == 2) {
+                group.altitudeMin = float(altitude[0].toDouble());
+                group.altitudeMax = float(altitude[1].toDouble());
+            }
+            wave.groups << group;
+        }
+        loaded.waves << wave;
+    }
+    if (loaded.waves.isEmpty()) {
+        if (error) *error = "no waves";
+        return false;
+    }
+    waves = loaded;
+    return true;
+}
+
+WaveSet defaultWaves() {
+    // Ten aircraft per level every 3 s; each level is faster and drops more
+    WaveSet set;
+    for (int level = 1; level <= 10; ++level) {
+        WaveSpec wave;
+        wave.name = QString("Level %1").arg(level);
+        wave.level = level;
+        wave.duration = 30;
+        wave.repeat = level == 10;
+        SpawnGroup group;
+        group.count = 10;
+        group.start = 3;
+        group.interval = 3;
+        group.speed = level;
+        group.dropRate = qMin(1 + 2 * (level - 1), 10);
+        wave.groups << group;
+        set.waves << wave;
+    }
+    return set;
+}
+
+void WaveDirector::start(const WaveSet& waves, quint32 seed) {
+    set = waves;
+    rng.seed(seed ^ 0x57415645u);   // "WAVE"
+    queue.clear();
+    head = 0;
+    nextWave = 0;
+    nextWaveTick = 0;
+    current.clear();
+}
+
+void WaveDirector::schedule(const WaveSpec& wave, quint64 startTick) {
+    // Drop what has been handed out, then append and re-sort what is left:
+    // a slow group can still be spawning when the next wave starts
+    queue.remove(0, head);
+    head = 0;
+    for (const SpawnGroup& g : wave.groups) {
+        for (int k = 0; k < g.count; ++k) {
+            SpawnEvent e;
+            e.tick = startTick + secondsToTicks(g.start + k * g.interval);
+            e.level = quint8(qBound(0, wave.level, 255));
+            float altitude = g.altitudeMin + float(rng.generateDouble()) * (g.altitudeMax - g.altitudeMin);
+            if (g.kind == SpawnTrooper) {
+                e.kind = KindFalling;
+                e.x = float(rng.bounded(WIDTH));
+                e.y = altitude;
+                e.vx = 0;
+                e.vy = TroopFallSpeed * STEP / 0.040;
+                e.dropChance = 0;
+            } else {
+                bool plane = g.kind == SpawnPlane || (g.kind == SpawnAircraft && rng.bounded(2) == 0);
+                e.kind = plane ? KindPlane : KindHeli;
+                e.x = 0;
+                e.y = altitude;
+                e.vx = g.speed * STEP / 0.040;
+                e.vy = 0;
+                e.dropChance = g.dropRate / 100.0f * STEP / 0.040;
+            }
+            queue << e;
+        }
+    }
+    // Groups interleave; a stable sort keeps file order within a tick
+    std::stable_sort(queue.begin(), queue.end(),
+                     [](const SpawnEvent& a, const SpawnEvent& b) { return a.tick < b.tick; });
+}
+
+bool WaveDirector::next(quint64 tick, SpawnEvent& out) {
+    // Expand waves as they start, so only the current one is ever queued
+    while (!set.waves.isEmpty() && tick >= nextWaveTick && nextWave >= 0) {
+        const WaveSpec& wave = set.waves[nextWave];
+        schedule(wave, nextWaveTick);
+        current = wave.name;
+        nextWaveTick += secondsToTicks(wave.duration);
+        if (!wave.repeat) nextWave = nextWave + 1 < set.waves.size() ? nextWave + 1 : -1;
+    }
+    if (head == queue.size() || queue[head].tick > tick) return false;
+    out = queue[head++];
+    return true;
+}
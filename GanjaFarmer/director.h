@@ -0,0 +1,84 @@
+#ifndef DIRECTOR_H
+#define DIRECTOR_H
+
+#include <QRandomGenerator>
+#include <QString>
+#include <QVector>
+
+// Waves of attackers, read from a JSON file instead of being hardcoded:
+//
+//   { "waves": [ { "name": "Scouts", "level": 1, "duration": 30,
+//                  "spawns": [ { "kind": "aircraft", "count": 10, "start": 0, "interval": 3,
+//                                "speed": 1, "dropRate": 1, "altitude": [30, 230] } ] },
+//                ...
+//                { "name": "...", "repeat": true, ... } ] }
+//
+// Waves run back to back; a wave marked "repeat" (normally the last) runs
+// again forever. Times are in seconds. "kind" is plane, heli, aircraft
+// (either) or trooper. Speeds and drop rates keep the original units: pixels
+// and percent chance of a drop per 40 ms.
+
+enum SpawnKind { SpawnPlane, SpawnHeli, SpawnAircraft, SpawnTrooper };
+
+struct SpawnGroup {
+    SpawnKind kind = SpawnAircraft;
+    int count = 1;
+    double start = 0, interval = 1;
+    float speed = 1;
+    float dropRate = 1;
+    float altitudeMin = 30, altitudeMax = 230;   // aircraft y, trooper start y
+};
+
+struct WaveSpec {
+    QString name;
+    int level = 1;
+    double duration = 30;
+    bool repeat = false;
+    QVector<SpawnGroup> groups;
+};
+
+struct WaveSet {
+    QVector<WaveSpec> waves;
+    quint32 checksum = 0;   // of the source file, so replays can check they match
+};
+
+bool loadWaves(const QString& path, WaveSet& waves, QString* error);
+// The old fixed curve, for when no file is given
+WaveSet defaultWaves();
+
+// One entity to add on a given tick, fully decided in advance
+struct SpawnEvent {
+    quint64 tick;
+    quint8 kind;        // EntityKind
+    quint8 level;
+    float x, y, vx, vy;
+    float dropChance;   // per tick, aircraft only
+};
+
+// Turns waves into a time-ordered queue of spawns. Each wave is expanded
+// when it starts, with its own generator derived from the seed, so the queue
+// is the same for the same seed and waves and doesn't consume the world's
+// random numbers.
+class WaveDirector {
+public:
+    void start(const WaveSet& waves, quint32 seed);
+
+    // Pops the next spawn due on or before `tick`; false when none is
+    bool next(quint64 tick, SpawnEvent& out);
+
+    int queued() const { return queue.size() - head; }
+    QString waveName() const { return current; }
+
+private:
+    void schedule(const WaveSpec& wave, quint64 startTick);
+
+    WaveSet set;
+    QRandomGenerator rng;
+    QVector<SpawnEvent> queue;
+    int head = 0;
+    int nextWave = 0;
+    quint64 nextWaveTick = 0;
+    QString current;
+};
+
+#endif // DIRECTOR_H
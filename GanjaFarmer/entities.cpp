@@ -0,0 +1,44 @@
+#include "entities.h"
+
+void EntityStore::reserve(int n) {
+    x.reserve(n); y.reserve(n);
+    prevX.reserve(n); prevY.reserve(n);
+    vx.reserve(n); vy.reserve(n);
+    dropChance.reserve(n);
+    kind.reserve(n);
+    dead.reserve(n);
+}
+
+int EntityStore::add(EntityKind k, float px, float py, float velX, float velY, float drop) {
+    x << px; y << py;
+    prevX << px; prevY << py;
+    vx << velX; vy << velY;
+    dropChance << drop;
+    kind << k;
+    dead << 0;
+    return kind.size() - 1;
+}
+
+void EntityStore::removeAt(int i) {
+    int last = kind.size() - 1;
+    if (i != last) {
+        x[i] = x[last]; y[i] = y[last];
+        prevX[i] = prevX[last]; prevY[i] = prevY[last];
+        vx[i] = vx[last]; vy[i] = vy[last];
+        dropChance[i] = dropChance[last];
+        kind[i] = kind[last];
+        dead[i] = dead[last];
+    }
+    // removeLast keeps capacity, so steady-state play never reallocates
+    x.removeLast(); y.removeLast();
+    prevX.removeLast(); prevY.removeLast();
+    vx.removeLast(); vy.removeLast();
+    dropChance.removeLast();
+    kind.removeLast();
+    dead.removeLast();
+}
+
+void EntityStore::removeDead() {
+    for (int i = kind.size() - 1; i >= 0; --i)
+        if (dead[i]) removeAt(i);
+}
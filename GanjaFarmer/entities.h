@@ -0,0 +1,34 @@
+#ifndef ENTITIES_H
+#define ENTITIES_H
+
+#include <QVector>
+
+enum EntityKind : quint8 {
+    KindPlane,
+    KindHeli,
+    KindFalling,   // paratrooper in the air, can be shot
+    KindTroop,     // landed, walking toward the edge
+    KindBullet,
+    KindCount
+};
+
+// Structure-of-arrays storage for everything that moves. One array per
+// component keeps the per-tick integration a tight loop over floats.
+// Removal swaps the last entity into the hole, so the arrays stay dense;
+// an index is only meaningful until the next removal.
+struct EntityStore {
+    QVector<float> x, y;          // top-left for sprites, centre for bullets
+    QVector<float> prevX, prevY;  // previous tick, for interpolated drawing
+    QVector<float> vx, vy;        // pixels per tick
+    QVector<float> dropChance;    // aircraft: chance per tick of dropping a trooper
+    QVector<quint8> kind;
+    QVector<quint8> dead;         // flagged during a tick, compacted at its end
+
+    int size() const { return kind.size(); }
+    void reserve(int n);
+    int add(EntityKind k, float px, float py, float velX, float velY, float drop = 0);
+    void removeAt(int i);
+    void removeDead();
+};
+
+#endif // ENTITIES_H
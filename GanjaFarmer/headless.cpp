@@ -0,0 +1,266 @@
+#include "headless.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLineF>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+
+#include "audiomixer.h"
+#include "replay.h"
+#include "world.h"
+
+namespace {
+const double BulletSpeed = 10 * (STEP / 0.016);   // px per tick, as GameWorld::fire()
+const int BotFireInterval = 12;                   // ticks between the bot's shots
+const quint64 DefaultTicks = 5 * 60 * 60;         // five minutes of play
+
+// Text input scripts, one action per line:
+//   <tick> aim <degrees>
+//   <tick> fire
+// Blank lines and lines starting with # are ignored. Ticks must not decrease.
+bool loadScript(const QString& path, QVector<InputEvent>& events, QString* error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *error = file.errorString();
+        return false;
+    }
+    QTextStream in(&file);
+    int lineNo = 0;
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        lineNo++;
+        if (line.isEmpty() || line.startsWith('#')) continue;
+        QStringList parts = line.split(' ', QString::SkipEmptyParts);
+        InputEvent e;
+        bool ok = parts.size() >= 2;
+        if (ok) e.tick = parts[0].toUInt(&ok);
+        if (ok && parts[1] == "aim" && parts.size() == 3) {
+            e.type = InputEvent::Aim;
+            e.angle = parts[2].toFloat(&ok);
+        } else if (ok && parts[1] == "fire" && parts.size() == 2) {
+            e.type = InputEvent::Fire;
+        } else {
+            ok = false;
+        }
+        if (ok && !events.isEmpty() && e.tick < events.last().tick) ok = false;
+        if (!ok) {
+            *error = QString("%1:%2: expected \"<tick> aim <degrees>\" or \"<tick> fire\"").arg(path).arg(lineNo);
+            return false;
+        }
+        events << e;
+    }
+    return true;
+}
+
+// Stand-in player: every few ticks it leads the lowest falling trooper (or
+// failing that the first aircraft) and fires. Deterministic for a world state.
+void botInput(const GameWorld& world, QVector<InputEvent>& out) {
+    if (world.ticks() % BotFireInterval != 0) return;
+    const EntityStore& es = world.entities();
+    int target = -1;
+    for (int i = 0; i < es.size(); ++i) {
+        if (es.kind[i] == KindFalling && (target < 0 || es.kind[target] != KindFalling || es.y[i] > es.y[target]))
+            target = i;
+        else if ((es.kind[i] == KindPlane || es.kind[i] == KindHeli) && target < 0)
+            target = i;
+    }
+    if (target < 0) return;
+
+    QPointF pivot = world.turretPivot();
+    QPointF at = world.bounds(target).center();
+    QPointF lead = at + QPointF(es.vx[target], es.vy[target]) * (QLineF(pivot, at).length() / BulletSpeed);
+    InputEvent e;
+    e.tick = quint32(world.ticks());
+    e.type = InputEvent::Aim;
+    e.angle = -QLineF(pivot, lead).angle();
+    out << e;
+    e.type = InputEvent::Fire;
+    out << e;
+}
+
+qint64 percentile(const QVector<qint64>& sorted, double p) {
+    if (sorted.isEmpty()) return 0;
+    return sorted[qMin(sorted.size() - 1, int(p * sorted.size()))];
+}
+}
+
+int runHeadless(const HeadlessConfig& options) {
+    QTextStream err(stderr);
+    HeadlessConfig config = options;
+    WaveSet waves;
+    QString wavesError;
+    if (!loadWaves(config.wavesPath, waves, &wavesError)) {
+        err << "Cannot read waves: " << config.wavesPath << ": " << wavesError << endl;
+        return 1;
+    }
+
+    QVector<InputEvent> script;
+    if (!config.inputPath.isEmpty()) {
+        QString error;
+        bool ok;
+        if (isReplayFile(config.inputPath)) {
+            Replay replay;
+            ok = loadReplay(config.inputPath, replay, &error);
+            if (ok && replay.waves != waves.checksum) {
+                error = "it was recorded with different waves than " + config.wavesPath;
+                ok = false;
+            }
+            config.seed = replay.seed;
+            config.stress = replay.stress;
+            if (config.ticks == 0) config.ticks = replay.endTick;
+            script = replay.events;
+        } else {
+            ok = loadScript(config.inputPath, script, &error);
+        }
+        if (!ok) {
+            err << "Cannot read input: " << error << endl;
+            return 1;
+        }
+    }
+    if (config.ticks == 0) config.ticks = DefaultTicks;
+
+    Replay recording;
+    recording.seed = config.seed;
+    recording.waves = waves.checksum;
+    recording.stress = config.stress;
+
+    GameWorld world(config.seed, waves);
+    world.setStressLevel(config.stress);
+
+    // Sound is mixed to a null sink, so the mixer is exercised like in play
+    AudioMixer mixer;
+    NullSink sink(&mixer);
+    QString audioError;
+    if (!mixer.load(&audioError)) err << "Sound disabled: " << audioError << endl;
+    qint64 mixNs = 0;
+
+    QVector<qint64> stepNs;
+    QVector<int> population;
+    stepNs.reserve(int(config.ticks));
+    population.reserve(int(config.ticks));
+    QVector<InputEvent> botEvents;
+    QJsonArray levelTicks;
+    int shots = 0, escaped = 0, peak = 0, next = 0;
+
+    QElapsedTimer wall, tickClock;
+    wall.start();
+    tickClock.start();
+    for (quint64 t = 0; t < config.ticks; ++t) {
+        if (config.inputPath.isEmpty()) {
+            botEvents.clear();
+            botInput(world, botEvents);
+            for (const InputEvent& e : botEvents) {
+                world.apply(e);
+                recording.append(e);
+            }
+        } else {
+            while (next < script.size() && script[next].tick == world.ticks()) {
+                recording.append(script[next]);
+                world.apply(script[next++]);
+            }
+        }
+
+        qint64 before = tickClock.nsecsElapsed();
+        world.step();
+        stepNs << tickClock.nsecsElapsed() - before;
+        population << world.entities().size();
+        peak = qMax(peak, world.entities().size());
+
+        for (const WorldEvent& e : world.events()) {
+            if (e.type == WorldEvent::Shot) {
+                shots++;
+                mixer.play(SoundShoot);
+            } else if (e.type == WorldEvent::Explosion) {
+                mixer.play(SoundExplosion);
+            } else if (e.type == WorldEvent::TroopEscaped) {
+                escaped++;
+                mixer.play(SoundFailure);
+            } else if (e.type == WorldEvent::LevelUp) {
+                levelTicks.append(qint64(world.ticks()));
+            }
+        }
+        world.clearEvents();
+
+        before = tickClock.nsecsElapsed();
+        sink.pump(STEP);
+        mixNs += tickClock.nsecsElapsed() - before;
+    }
+    qint64 wallNs = wall.nsecsElapsed();
+    recording.endTick = world.ticks();
+
+    if (!config.recordPath.isEmpty()) {
+        QString error;
+        if (!saveReplay(config.recordPath, recording, &error)) {
+            err << "Cannot write replay: " << error << endl;
+            return 1;
+        }
+    }
+
+    QVector<qint64> sorted = stepNs;
+    std::sort(sorted.begin(), sorted.end());
+    qint64 total = 0;
+    for (qint64 ns : stepNs) total += ns;
+
+    const GameStats& st = world.stats();
+    QJsonObject stepStats;
+    stepStats["meanNs"] = stepNs.isEmpty() ? 0 : double(total) / stepNs.size();
+    stepStats["p50Ns"] = percentile(sorted, 0.50);
+    stepStats["p95Ns"] = percentile(sorted, 0.95);
+    stepStats["p99Ns"] = percentile(sorted, 0.99);
+    stepStats["maxNs"] = sorted.isEmpty() ? 0 : sorted.last();
+
+    QJsonObject stats;
+    stats["seed"] = qint64(config.seed);
+    stats["ticks"] = qint64(config.ticks);
+    stats["gameSeconds"] = config.ticks * STEP;
+    stats["input"] = config.inputPath.isEmpty() ? QString("bot") : config.inputPath;
+    stats["stress"] = config.stress;
+    stats["waves"] = config.wavesPath;
+    stats["lastWave"] = world.waveName();
+    stats["score"] = st.score;
+    stats["kills"] = st.kills;
+    stats["explosions"] = st.explosions;
+    stats["level"] = st.level;
+    stats["shots"] = shots;
+    stats["escaped"] = escaped;
+    stats["levelTicks"] = levelTicks;
+    stats["peakEntities"] = peak;
+    stats["wallMs"] = wallNs / 1e6;
+    stats["ticksPerSecond"] = wallNs > 0 ? config.ticks / (wallNs / 1e9) : 0;
+    stats["step"] = stepStats;
+    AudioMixer::Stats sound = mixer.stats();
+    QJsonObject audio;
+    audio["played"] = sound.played;
+    audio["stolen"] = sound.stolen;
+    audio["meanMixNsPerTick"] = config.ticks ? double(mixNs) / config.ticks : 0;
+    stats["audio"] = audio;
+    QByteArray json = QJsonDocument(stats).toJson(QJsonDocument::Indented);
+
+    if (config.statsPath.isEmpty()) {
+        fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    } else {
+        QFile out(config.statsPath);
+        if (!out.open(QIODevice::WriteOnly) || out.write(json) != json.size()) {
+            err << "Cannot write stats: " << out.errorString() << endl;
+            return 1;
+        }
+    }
+
+    if (!config.timingsPath.isEmpty()) {
+        QFile out(config.timingsPath);
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            err << "Cannot write timings: " << out.errorString() << endl;
+            return 1;
+        }
+        QTextStream csv(&out);
+        csv << "tick,step_ns,entities\n";
+        for (int i = 0; i < stepNs.size(); ++i)
+            csv << i + 1 << ',' << stepNs[i] << ',' << population[i] << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,23 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <QString>
+
+// Runs the game logic with no window, timers or sound: as many ticks as asked
+// for, as fast as they go, from a seed and either an input script, a replay
+// or the built-in bot. Balance runs and perf regressions finish in seconds.
+struct HeadlessConfig {
+    quint32 seed = 1;
+    quint64 ticks = 0;             // 0: the replay's length, or five minutes of play
+    int stress = 0;
+    QString wavesPath = ":/assets/waves.json";
+    QString inputPath;             // text script or replay (whose seed and stress win); empty uses the bot
+    QString recordPath;            // save the run as a replay; empty skips it
+    QString statsPath;             // JSON summary; empty writes it to stdout
+    QString timingsPath;           // per-tick CSV of step time and entity count; empty skips it
+};
+
+// Returns the process exit code
+int runHeadless(const HeadlessConfig& config);
+
+#endif // HEADLESS_H
@@ -0,0 +1,17 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <QtGlobal>
+
+// One player action, stamped with the tick it happened on: world.ticks() at
+// the time, so it is applied before the following step(). A session is the
+// world's seed plus the list of these.
+struct InputEvent {
+    enum Type : quint8 { Aim, Fire };
+
+    quint32 tick = 0;
+    Type type = Fire;
+    float angle = 0;   // Aim only, scene degrees like GameWorld::aim()
+};
+
+#endif // INPUT_H
@@ -0,0 +1,45 @@
+#ifndef ITEMPOOL_H
+#define ITEMPOOL_H
+
+#include <QGraphicsScene>
+#include <QGraphicsItem>
+#include <QVector>
+#include <functional>
+
+// Scene items for one kind of sprite, handed out again every frame instead of
+// being created and deleted per entity. Items past this frame's count are
+// hidden; the pool only grows when more are on screen than ever before.
+class ItemPool {
+public:
+    ItemPool(QGraphicsScene* scene, std::function<QGraphicsItem*()> factory)
+        : scene(scene), factory(factory) {}
+
+    void begin() { used = 0; }
+
+    QGraphicsItem* next() {
+        if (used == items.size()) {
+            QGraphicsItem* item = factory();
+            scene->addItem(item);
+            items << item;
+        }
+        QGraphicsItem* item = items[used];
+        if (used >= shown) item->show();
+        used++;
+        return item;
+    }
+
+    void end() {
+        for (int i = used; i < shown; ++i) items[i]->hide();
+        shown = used;
+    }
+
+    int capacity() const { return items.size(); }
+
+private:
+    QGraphicsScene* scene;
+    std::function<QGraphicsItem*()> factory;
+    QVector<QGraphicsItem*> items;   // owned by the scene
+    int used = 0, shown = 0;
+};
+
+#endif // ITEMPOOL_H
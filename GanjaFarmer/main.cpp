@@ -4,227 +4,432 @@
 #include <QGraphicsPixmapItem>
 #include <QGraphicsTextItem>
 #include <QGraphicsSceneMouseEvent>
-#include <QSoundEffect>
+#include <QKeyEvent>
+#include <QCommandLineParser>
 #include <QTimer>
 #include <QtMath>
-#include <QTime>
+#include <QRandomGenerator>
+#include <QScopedPointer>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <qdebug.h>
 
-const int WIDTH = 800, HEIGHT = 600;
-const int TURRET_LIMIT = 45;
+#include "world.h"
+#include "audiomixer.h"
+#include "audiooutput.h"
+#include "batchitem.h"
+#include "headless.h"
+#include "itempool.h"
+#include "perfoverlay.h"
+#include "replay.h"
+#include "spriteatlas.h"
+
+const double MAX_FRAME = 0.25;    // after a stall, drop time rather than spiral
+const int AudioBufferMs = 20;
 
 class GameScene : public QGraphicsScene {
     Q_OBJECT
 public:
-    GameScene() : QGraphicsScene(0,0,WIDTH,HEIGHT) {
+    GameScene(quint32 seed, const WaveSet& waves) : QGraphicsScene(0,0,WIDTH,HEIGHT), world(seed, waves) {
         setBackgroundBrush(Qt::black);
         hud = addText(QString(), QFont{"Arial",14});
         hud->setDefaultTextColor(Qt::white);
         hud->setPos(10,10);
 
-        turretBase = addPixmap(QPixmap(":/assets/images/turret_base.png"));
+        // Pixmaps arrive with the atlas; until then these are empty
+        background = addPixmap(QPixmap());
+        background->setZValue(-1000); // Very low so everything draws on top
+        turretBase = addPixmap(QPixmap());
         turretBase->setPos(WIDTH/2 - 25, HEIGHT - 100);
-
-        turretBarrel = addPixmap(QPixmap(":/assets/images/turret_barrel.png").scaled(30, 30, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+        turretBarrel = addPixmap(QPixmap());
         turretBarrel->setTransformOriginPoint(0, 15);  // left-center, matches new image
         turretBarrel->setPos(WIDTH/2, HEIGHT - 100);   // adjust Y to match turret base
 
+        // Pooled items share the atlas pieces, so spawning does no image work
+        pools[KindPlane] = new ItemPool(this, [this]() { return new QGraphicsPixmapItem(atlas.pixmap(SpritePlane)); });
+        pools[KindHeli] = new ItemPool(this, [this]() { return new QGraphicsPixmapItem(atlas.pixmap(SpriteHeli)); });
+        for (EntityKind k : {KindFalling, KindTroop}) {
+            pools[k] = new ItemPool(this, [this]() {
+                QGraphicsPixmapItem* item = new QGraphicsPixmapItem(atlas.pixmap(SpriteTrooper));
+                item->setZValue(1);
+                return item;
+            });
+        }
+        pools[KindBullet] = new ItemPool(this, [this]() {
+            QGraphicsPixmapItem* bullet = new QGraphicsPixmapItem(atlas.pixmap(SpriteBullet));
+            bullet->setOffset(-2, -2);
+            bullet->setZValue(2);
+            return bullet;
+        });
 
-        // Sounds
-        shootSound.setSource(QUrl("qrc:/assets/sounds/shoot.wav"));
-        explosionSound.setSource(QUrl("qrc:/assets/sounds/explosion.wav"));
-        failSound.setSource(QUrl("qrc:/assets/sounds/failure.wav"));
+        batch = new BatchItem(&atlas, &world);
+        batch->hide();
+        addItem(batch);
+        particleItem = new ParticleItem(&atlas, &particles);
+        addItem(particleItem);
+        overlay = new PerfOverlay(&world, &particles);
+        addItem(overlay);
+
+        // Sounds are decoded once and mixed into a single output stream
+        QString error;
+        if (!mixer.load(&error))
+            qWarning() << "Sound disabled:" << error;
+        else if (!audio.start(AudioBufferMs, &error))
+            qWarning() << "No audio device, mixing to a null sink:" << error;
+        else
+            audioLive = true;
+
+        // One loop drives everything: fixed-size simulation ticks, drawing in between.
+        // It starts once the sprites are decoded and scaled on a worker thread.
+        connect(&frameTimer, &QTimer::timeout, this, &GameScene::frame);
+        frameTimer.setTimerType(Qt::PreciseTimer);
+        connect(&atlasWatcher, &QFutureWatcher<AtlasImage>::finished, this, &GameScene::atlasReady);
+        atlasWatcher.setFuture(SpriteAtlas::buildAsync());
 
-      //  connect(&gameTimer, &QTimer::timeout, this, &GameScene::gameLoop);
-     //   gameTimer.start(16);
+        updateHUD();
+    }
 
-        connect(&spawnTimer, &QTimer::timeout, this, &GameScene::spawnAircraft);
-        spawnTimer.start(3000);
+    ~GameScene() {
+        qDeleteAll(pools, pools + KindCount);
+    }
 
+    // Draw through the single batched item instead of one pooled item per entity
+    void setBatched(bool on) {
+        batched = on;
+        batch->setVisible(on);
         updateHUD();
     }
 
-protected:
-    void mouseMoveEvent(QGraphicsSceneMouseEvent* e) override {
-        QPointF pivot = turretBarrel->mapToScene(turretBarrel->transformOriginPoint());
-        QLineF line(pivot, e->scenePos());
-        qreal angle = -line.angle();
+    void setStress(int entities) {
+        world.setStressLevel(entities);
+        updateHUD();
+    }
 
-        // Limit turret rotation: only allow -90° to +90°
-       // if (angle > 90) angle = 90;
-       // if (angle < -90) angle = -90;
+    // Keep every input for session() so it can be saved as a replay
+    void startRecording() {
+        recording = true;
+        recorded = Replay();
+        recorded.seed = world.seed();
+        recorded.waves = world.wavesChecksum();
+        recorded.stress = world.stressLevel();
+    }
 
-        turretBarrel->setRotation(angle);
+    Replay session() const {
+        Replay r = recorded;
+        r.endTick = world.ticks();
+        return r;
     }
 
+    // The view reports how long its last paint took, for the overlay
+    void setPaintTime(qint64 ns) { paintNs = ns; }
+
+    // Drive the world from a replay instead of the mouse. The scene must have
+    // been made with the replay's seed, waves and stress.
+    void startPlayback(const Replay& replay, double speed) {
+        playback = replay;
+        playbackNext = 0;
+        playing = true;
+        replayEnded = false;
+        timeScale = speed;
+        updateHUD();
+    }
 
+protected:
+    void mouseMoveEvent(QGraphicsSceneMouseEvent* e) override {
+        QLineF line(world.turretPivot(), e->scenePos());
+        input(InputEvent::Aim, -line.angle());
+    }
 
+    void mousePressEvent(QGraphicsSceneMouseEvent*) override {
+        input(InputEvent::Fire);
+        handleEvents();
+    }
 
-    void mousePressEvent(QGraphicsSceneMouseEvent*) override { shoot(); }
+    // B switches renderer, S steps through stress loads, to compare the two;
+    // E sets off a few hundred explosions to load the particle system and
+    // P hides the perf overlay.
+    // F fast-forwards a replay. Stress isn't an input, so it is fixed while
+    // recording or replaying.
+    void keyPressEvent(QKeyEvent* e) override {
+        if (e->key() == Qt::Key_B) {
+            setBatched(!batched);
+        } else if (e->key() == Qt::Key_S && !recording && !playing) {
+            int level = world.stressLevel();
+            setStress(level == 0 ? 1000 : level < 5000 ? level * 2 : 0);
+        } else if (e->key() == Qt::Key_E) {
+            // A burst of explosions to check particles stay cheap
+            for (int i = 0; i < 200; ++i)
+                particles.explosion(QRandomGenerator::global()->bounded(WIDTH), QRandomGenerator::global()->bounded(GROUND_Y));
+        } else if (e->key() == Qt::Key_P) {
+            overlay->setVisible(!overlay->isVisible());
+        } else if (e->key() == Qt::Key_F && playing) {
+            timeScale = timeScale >= 64 ? 1 : timeScale * 2;
+            updateHUD();
+        } else {
+            QGraphicsScene::keyPressEvent(e);
+        }
+    }
 
 private slots:
-    void gameLoop() {
-        for (auto it = items().begin(); it!=items().end(); ) {
-            QGraphicsItem* itItem = *it++;
-            if (itItem->data(0)=="troop") {
-                itItem->moveBy(1,0);
-                if (itItem->x() > WIDTH) {
-                    removeItem(itItem);
-                    delete itItem;
-                    score -= 10;
-                    failSound.play();
-                    updateHUD();
-                }
-            }
-        }
+    void atlasReady() {
+        AtlasImage image = atlasWatcher.result();
+        atlas.upload(image);
+        atlasMs = image.buildMs;
+        background->setPixmap(atlas.pixmap(SpriteBackground));
+        turretBase->setPixmap(atlas.pixmap(SpriteTurretBase));
+        turretBarrel->setPixmap(atlas.pixmap(SpriteTurretBarrel));
+        clock.start();
+        frameTimer.start(8);
+        updateHUD();
     }
 
-    void spawnAircraft() {
-        spawnCount++;
-        if (spawnCount %10==0 && level<10) {
-            level++;
-            speed++;
-            dropRate = qMin(dropRate+2, 10);
+    void frame() {
+        qint64 now = clock.nsecsElapsed();
+        double dt = qMin((now - lastFrameNs) / 1e9, MAX_FRAME);
+        lastFrameNs = now;
+        accumulator += dt * timeScale;
+
+        QElapsedTimer work;
+        work.start();
+        int steps = 0;
+        while (accumulator >= STEP) {
+            if (playing && !playbackTick()) {
+                accumulator = 0;
+                break;
+            }
+            world.step();
+            accumulator -= STEP;
+            steps++;
+        }
+        handleEvents();
+        qint64 updateNs = work.nsecsElapsed();
+        particles.update(float(dt));
+        qint64 particleNs = work.nsecsElapsed() - updateNs;
+        if (!audioLive) nullSink.pump(dt);
+        qint64 renderStart = work.nsecsElapsed();
+        render(accumulator / STEP);
+        particleItem->update();
+        qint64 renderNs = work.nsecsElapsed() - renderStart + paintNs;
+        if (overlay->isVisible()) overlay->record(updateNs / 1e6, renderNs / 1e6);
+
+        // Smoothed frame stats for the overlay
+        frameMs += (dt * 1000.0 - frameMs) * 0.05;
+        updateMs += (updateNs / 1e6 - updateMs) * 0.05;
+        renderMs += (renderNs / 1e6 - renderMs) * 0.05;
+        particleMs += (particleNs / 1e6 - particleMs) * 0.05;
+        worstFrameMs = qMax(worstFrameMs, dt * 1000.0);
+        if (now - lastHudNs > 250000000) {
+            lastHudNs = now;
             updateHUD();
+            worstFrameMs = 0;
         }
-
-        bool isPlane = (qrand()%2)==0;
-        auto pix = QPixmap(isPlane ? ":/assets/images/airplane.png" : ":/assets/images/helicopter.png").scaled(90, 90, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        auto ac = addPixmap(pix);
-        ac->setData(0, isPlane ? "plane" : "heli");
-        ac->setPos(0, qrand()%200 + 30);
-
-        QTimer* t = new QTimer(this);
-        connect(t, &QTimer::timeout, this, [=]() mutable {
-            if (!ac->scene()) { t->stop(); t->deleteLater(); return; }
-            ac->moveBy(speed, 0);
-            if (qrand()%100 < dropRate) dropParatrooper(ac->pos());
-            if (ac->x() > WIDTH) { removeItem(ac); delete ac; t->stop(); t->deleteLater(); }
-        });
-        t->start(40);
     }
 
-    void dropParatrooper(const QPointF& p) {
-        QGraphicsPixmapItem* trooper = addPixmap(QPixmap(":/assets/images/paratrooper.png").scaled(30, 30, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        trooper->setData(0, "falling");
-        trooper->setPos(p.x(), p.y());
+private:
+    // Player input goes through here so it can be recorded, and so live and
+    // replayed sessions feed the world identical values
+    void input(InputEvent::Type type, float angle = 0) {
+        if (playing) return;
+        InputEvent e;
+        e.tick = quint32(world.ticks());
+        e.type = type;
+        e.angle = angle;
+        world.apply(e);
+        if (recording) recorded.append(e);
+    }
 
-        QTimer* fallTimer = new QTimer(this);
-        connect(fallTimer, &QTimer::timeout, this, [=]() mutable {
-            if (!trooper->scene()) {
-                fallTimer->stop();
-                fallTimer->deleteLater();
-                return;
-            }
+    // Applies the replay's input for the coming tick; false once it has run out
+    bool playbackTick() {
+        if (world.ticks() >= playback.endTick) {
+            playing = false;
+            timeScale = 0;   // hold the last frame
+            replayEnded = true;
+            updateHUD();
+            return false;
+        }
+        while (playbackNext < playback.events.size() && playback.events[playbackNext].tick == world.ticks())
+            world.apply(playback.events[playbackNext++]);
+        return true;
+    }
 
-            trooper->moveBy(0, 3);  // falling speed
-     trooper->setZValue(1);
-            if (trooper->y() >= HEIGHT - 100) { // ground level
-                trooper->setData(0, "troop");
-                fallTimer->stop();
-                fallTimer->deleteLater();
+    // Sounds and HUD for whatever the world reported since last time
+    void handleEvents() {
+        const QVector<WorldEvent>& events = world.events();
+        if (events.isEmpty()) return;
+        for (const WorldEvent& e : events) {
+            switch (e.type) {
+            case WorldEvent::Shot:
+                mixer.play(SoundShoot);
+                particles.muzzleFlash(e.x, e.y, world.turretAngle());
+                break;
+            case WorldEvent::Explosion:
+                mixer.play(SoundExplosion);
+                particles.explosion(e.x, e.y);
+                break;
+            case WorldEvent::TrooperKilled:
+                particles.puff(e.x, e.y);
+                break;
+            case WorldEvent::TroopEscaped: mixer.play(SoundFailure); break;
+            default: break;
             }
-        });
-        fallTimer->start(40);
+        }
+        world.clearEvents();
+        updateHUD();
     }
 
-    void shoot()
-    {
-        shootSound.play();
-
-        auto turretTipPos = turretBarrel->mapToScene(QPointF(25,0));
-        qreal turretAngle = turretBarrel->rotation();
-
-        // Create bullet shape (adjust size and color as needed)
-        QGraphicsEllipseItem* bullet = new QGraphicsEllipseItem(-2, -2, 4, 4);
-        bullet->setBrush(Qt::yellow);
-        bullet->setPen(Qt::NoPen);
-        bullet->setPos(turretTipPos);
-        bullet->setData(0, "bullet");
-        addItem(bullet);
-
-        bullet->setZValue(2);
-
-        // Store the angle at time of firing
-        qreal angle = -turretAngle;
-
-        QTimer* bulletTimer = new QTimer(this);
-
-        connect(bulletTimer, &QTimer::timeout, this, [=]() {
-            // Move bullet in its own angle direction
-            bullet->moveBy(qCos(qDegreesToRadians(angle)) * 10,
-                           -qSin(qDegreesToRadians(angle)) * 10);
-
-            // Check bounds
-            if (!sceneRect().contains(bullet->pos())) {
-                removeItem(bullet);
-                delete bullet;
-                bulletTimer->stop();
-                bulletTimer->deleteLater();
-                return;
+    // Draw every entity between its last two ticks, either through the batch
+    // item or by placing pooled items (which are all hidden in batched mode)
+    void render(double alpha) {
+        turretBarrel->setRotation(world.turretAngle());
+        for (ItemPool* pool : pools) pool->begin();
+        if (batched) {
+            batch->setFrame(alpha);
+        } else {
+            const EntityStore& es = world.entities();
+            for (int i = 0; i < es.size(); ++i) {
+                float x = es.prevX[i] + (es.x[i] - es.prevX[i]) * alpha;
+                float y = es.prevY[i] + (es.y[i] - es.prevY[i]) * alpha;
+                pools[es.kind[i]]->next()->setPos(x, y);
             }
+        }
+        for (ItemPool* pool : pools) pool->end();
+    }
 
-            // Handle collisions
-            for (QGraphicsItem* item : bullet->collidingItems()) {
-                QString type = item->data(0).toString();
-
-                for (auto item : bullet->collidingItems()) {
-                    qDebug() << "Bullet hit:" << item->data(0).toString();
-                }
-
-
-                if (type == "falling" || type == "plane" || type == "heli") {
-                    if (type != "falling") {
-                        explosions++;
-                        explosionSound.play(); // <-- Your explosion function
-                    } else {
-                        kills++;
-                    }
-
-                    updateHUD(); // <- Your HUD update logic
-
-                    removeItem(item);
-                   // delete item;
-
-                    removeItem(bullet);
-                    delete bullet;
-
-                    bulletTimer->stop();
-                    bulletTimer->deleteLater();
-                    return;
-                }
-            }
-        });
+    QGraphicsPixmapItem *background, *turretBase, *turretBarrel;
+    QGraphicsTextItem *hud;
+    AudioMixer mixer;
+    AudioOutput audio{&mixer};
+    NullSink nullSink{&mixer};
+    bool audioLive = false;
+    SpriteAtlas atlas;
+    QFutureWatcher<AtlasImage> atlasWatcher;
+    QTimer frameTimer;
+    QElapsedTimer clock;
+    GameWorld world;
+    ItemPool* pools[KindCount];
+    BatchItem* batch;
+    ParticleSystem particles;
+    ParticleItem* particleItem;
+    PerfOverlay* overlay;
+    bool batched = false;
+    Replay recorded, playback;
+    int playbackNext = 0;
+    bool recording = false, playing = false;
+    bool replayEnded = false;  // the HUD says so until another replay starts
+    double timeScale = 1;   // game seconds per real second; above 1 fast-forwards a replay
+    qint64 lastFrameNs = 0, lastHudNs = 0;
+    double accumulator = 0;
+    double frameMs = 0, updateMs = 0, renderMs = 0, particleMs = 0, worstFrameMs = 0;
+    double atlasMs = 0;     // building the sprite sheet, once at startup
+    qint64 paintNs = 0;
 
-        bulletTimer->start(16); // ~60 FPS
+    void updateHUD() {
+        const GameStats& st = world.stats();
+        hud->setPlainText(QString("Score: %1   Kills: %2   Explosions: %3   Level: %4%5")
+                          .arg(st.score).arg(st.kills).arg(st.explosions).arg(st.level)
+                          .arg(playing ? QString("\nreplay tick %1/%2  x%3").arg(world.ticks()).arg(playback.endTick).arg(timeScale)
+                               : replayEnded ? QString("\nreplay finished at tick %1").arg(world.ticks()) : QString()));
+
+        AudioMixer::Stats sound = mixer.stats();
+        overlay->setStatus(QString("%1 fps   frame %2 ms (worst %3)\nupdate %4 ms   render %5 ms   particles %6 ms\n"
+                                   "%7 renderer%8   audio %9 %10 ms (max %11, buffer %12 ms) stolen %13\nsprite atlas %14 ms")
+                           .arg(frameMs > 0 ? 1000.0 / frameMs : 0, 0, 'f', 0)
+                           .arg(frameMs, 0, 'f', 1).arg(worstFrameMs, 0, 'f', 1)
+                           .arg(updateMs, 0, 'f', 2).arg(renderMs, 0, 'f', 2).arg(particleMs, 0, 'f', 2)
+                           .arg(batched ? "batched" : "item")
+                           .arg(world.stressLevel() ? QString("   stress %1").arg(world.stressLevel()) : QString())
+                           .arg(audioLive ? "live" : "null").arg(sound.meanLatencyMs, 0, 'f', 1)
+                           .arg(sound.maxLatencyMs, 0, 'f', 1).arg(audioLive ? audio.bufferMs() : 0).arg(sound.stolen)
+                           .arg(atlasMs, 0, 'f', 1));
     }
+};
 
+// Times its own paints so the overlay can show real render cost, not just
+// the time spent placing items
+class GameView : public QGraphicsView {
+public:
+    explicit GameView(GameScene* scene) : QGraphicsView(scene), game(scene) {}
 
+protected:
+    void paintEvent(QPaintEvent* e) override {
+        QElapsedTimer t;
+        t.start();
+        QGraphicsView::paintEvent(e);
+        game->setPaintTime(t.nsecsElapsed());
+    }
 
 private:
-    QGraphicsPixmapItem *turretBase, *turretBarrel;
-    QGraphicsTextItem *hud;
-    QSoundEffect shootSound, explosionSound, failSound;
-    QTimer gameTimer, spawnTimer;
-    int score=0, kills=0, explosions=0, level=1, speed=1, dropRate=1, spawnCount=0;
-
-    void updateHUD() {
-        hud->setPlainText(QString("Score: %1   Kills: %2   Explosions: %3   Level: %4")
-                          .arg(score).arg(kills).arg(explosions).arg(level));
-    }
+    GameScene* game;
 };
 
 int main(int argc, char *argv[]) {
-    QApplication app(argc, argv);
-    qsrand(QTime::currentTime().msec());
+    // Headless runs must not need a display, so pick the application type first
+    bool headless = false;
+    for (int i = 1; i < argc; ++i)
+        if (qstrcmp(argv[i], "--headless") == 0) headless = true;
+    QScopedPointer<QCoreApplication> app(headless ? new QCoreApplication(argc, argv) : new QApplication(argc, argv));
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption({"batched", "Draw with the single batched item instead of pooled scene items (toggle with B)."});
+    parser.addOption({"stress", "Keep at least <n> entities alive (cycle with S).", "n", "0"});
+    parser.addOption({"seed", "Seed the game with <n> instead of a random value.", "n"});
+    parser.addOption({"waves", "Load attack waves from <file> (:/assets/waves_stress.json floods the screen).", "file", ":/assets/waves.json"});
+    parser.addOption({"record", "Save the session as a replay to <file> on exit.", "file"});
+    parser.addOption({"replay", "Play back the replay in <file> instead of taking input.", "file"});
+    parser.addOption({"speed", "Replay at <n> times real speed (F doubles it while playing).", "n", "1"});
+    parser.addOption({"headless", "Run the game logic without a window, at full speed, and print stats as JSON."});
+    parser.addOption({"ticks", "Headless: simulate <n> ticks, 60 per game second (default: the replay's length, or 18000).", "n"});
+    parser.addOption({"input", "Headless: take player input from <file>, a text script or a replay, instead of the built-in bot.", "file"});
+    parser.addOption({"stats", "Headless: write the JSON stats to <file> instead of stdout.", "file"});
+    parser.addOption({"timings", "Headless: write per-tick step time and entity count to <file> as CSV.", "file"});
+    parser.process(*app);
+
+    quint32 seed = parser.isSet("seed") ? parser.value("seed").toUInt() : QRandomGenerator::global()->generate();
+
+    if (headless) {
+        HeadlessConfig config;
+        config.seed = seed;
+        config.wavesPath = parser.value("waves");
+        config.ticks = parser.value("ticks").toULongLong();
+        config.stress = parser.value("stress").toInt();
+        config.inputPath = parser.isSet("replay") ? parser.value("replay") : parser.value("input");
+        config.recordPath = parser.value("record");
+        config.statsPath = parser.value("stats");
+        config.timingsPath = parser.value("timings");
+        return runHeadless(config);
+    }
 
-    GameScene scene;
-    QGraphicsView view(&scene);
+    WaveSet waves;
+    QString error;
+    if (!loadWaves(parser.value("waves"), waves, &error)) {
+        qWarning() << "Cannot load waves:" << error;
+        return 1;
+    }
 
-    QPixmap backgroundPixmap(":/assets/images/background.png");  // Or your file path
-    QGraphicsPixmapItem* background = new QGraphicsPixmapItem(backgroundPixmap);
-    background->setZValue(-1000); // Very low so everything draws on top
-    scene.addItem(background);
+    Replay replay;
+    if (parser.isSet("replay")) {
+        if (!loadReplay(parser.value("replay"), replay, &error)) {
+            qWarning() << "Cannot load replay:" << error;
+            return 1;
+        }
+        if (replay.waves != waves.checksum) {
+            qWarning() << "Replay was recorded with different waves than" << parser.value("waves");
+            return 1;
+        }
+        seed = replay.seed;
+    }
+
+    GameScene scene(seed, waves);
+    scene.setBatched(parser.isSet("batched"));
+    if (parser.isSet("replay")) {
+        scene.setStress(replay.stress);
+        scene.startPlayback(replay, qMax(1.0, parser.value("speed").toDouble()));
+    } else {
+        scene.setStress(parser.value("stress").toInt());
+        if (parser.isSet("record")) scene.startRecording();
+    }
+    GameView view(&scene);
 
     view.setRenderHint(QPainter::Antialiasing);
     view.setMouseTracking(true);
@@ -232,7 +437,15 @@ int main(int argc, char *argv[]) {
     view.setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     view.setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     view.show();
-    return app.exec();
+    int status = app->exec();
+
+    if (parser.isSet("record")) {
+        if (!saveReplay(parser.value("record"), scene.session(), &error)) {
+            qWarning() << "Cannot save replay:" << error;
+            return 1;
+        }
+    }
+    return status;
 }
 
 #include "main.moc"
@@ -0,0 +1,89 @@
+#include "particles.h"
+
+#include <QtMath>
+
+namespace {
+const float Drag = 2.0f;   // fraction of velocity lost per second
+}
+
+ParticleSystem::ParticleSystem(int capacity) {
+    x.resize(capacity); y.resize(capacity);
+    vx.resize(capacity); vy.resize(capacity);
+    life.resize(capacity); maxLife.resize(capacity);
+    scale.resize(capacity);
+    gravity.resize(capacity);
+    sprite.resize(capacity);
+}
+
+// xorshift32: cheap, and separate from the world's seeded generator
+float ParticleSystem::random() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::spawn(float px, float py, float speed, float degrees, float spread,
+                          float lifetime, float size, float weight, Sprite look) {
+    if (count == capacity()) return;
+    int i = count++;
+    float a = qDegreesToRadians(degrees + (random() - 0.5f) * spread);
+    float v = speed * (0.4f + 0.6f * random());
+    x[i] = px;
+    y[i] = py;
+    vx[i] = qCos(a) * v;
+    vy[i] = qSin(a) * v;
+    life[i] = maxLife[i] = lifetime * (0.6f + 0.4f * random());
+    scale[i] = size * (0.7f + 0.6f * random());
+    gravity[i] = weight;
+    sprite[i] = quint8(look);
+}
+
+void ParticleSystem::explosion(float px, float py) {
+    for (int i = 0; i < 28; ++i) spawn(px, py, 260, 0, 360, 0.6f, 1.0f, 220, SpriteSpark);
+    for (int i = 0; i < 16; ++i) spawn(px, py, 120, 0, 360, 0.9f, 1.6f, 60, SpriteEmber);
+    for (int i = 0; i < 10; ++i) spawn(px, py, 40, -90, 180, 1.4f, 2.5f, -30, SpriteSmoke);
+}
+
+void ParticleSystem::puff(float px, float py) {
+    for (int i = 0; i < 12; ++i) spawn(px, py, 90, 0, 360, 0.5f, 1.2f, 120, SpriteEmber);
+    for (int i = 0; i < 4; ++i) spawn(px, py, 25, -90, 120, 0.8f, 1.8f, -20, SpriteSmoke);
+}
+
+void ParticleSystem::muzzleFlash(float px, float py, float degrees) {
+    for (int i = 0; i < 8; ++i) spawn(px, py, 320, degrees, 30, 0.12f, 0.8f, 0, SpriteSpark);
+}
+
+void ParticleSystem::update(float dt) {
+    float* px = x.data();
+    float* py = y.data();
+    float* pvx = vx.data();
+    float* pvy = vy.data();
+    float* left = life.data();
+    const float* g = gravity.constData();
+    const float keep = qMax(0.0f, 1.0f - Drag * dt);
+    const int n = count;
+
+    for (int i = 0; i < n; ++i) {
+        px[i] += pvx[i] * dt;
+        py[i] += pvy[i] * dt;
+        pvx[i] *= keep;
+        pvy[i] = pvy[i] * keep + g[i] * dt;
+        left[i] -= dt;
+    }
+
+    for (int i = 0; i < count;) {
+        if (left[i] > 0) {
+            ++i;
+            continue;
+        }
+        int last = --count;
+        px[i] = px[last]; py[i] = py[last];
+        pvx[i] = pvx[last]; pvy[i] = pvy[last];
+        left[i] = left[last];
+        maxLife[i] = maxLife[last];
+        scale[i] = scale[last];
+        gravity[i] = gravity[last];
+        sprite[i] = sprite[last];
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <QVector>
+
+#include "spriteatlas.h"
+
+// Cosmetic particles for explosions, hits and muzzle flashes. They never
+// touch game state, so they run on real frame time and their own generator
+// and don't disturb seeded play or replays.
+//
+// Storage is a fixed-capacity structure of arrays allocated once. update()
+// integrates everything in one branch-free loop over plain float arrays, then
+// compacts the expired ones by swapping in the last; when the pool is full
+// new particles are simply not emitted.
+class ParticleSystem {
+public:
+    explicit ParticleSystem(int capacity = 16384);
+
+    void explosion(float x, float y);
+    void puff(float x, float y);
+    void muzzleFlash(float x, float y, float degrees);
+    void update(float dt);
+
+    int size() const { return count; }
+    int capacity() const { return x.size(); }
+
+    // Live particles are [0, size())
+    QVector<float> x, y, vx, vy;
+    QVector<float> life, maxLife;   // seconds left, and at birth
+    QVector<float> scale;           // relative to the sprite
+    QVector<float> gravity;         // px/s², negative rises
+    QVector<quint8> sprite;         // a Sprite
+
+private:
+    void spawn(float px, float py, float speed, float degrees, float spread,
+              float lifetime, float size, float weight, Sprite look);
+    float random();   // [0, 1)
+
+    int count = 0;
+    quint32 rngState = 0x9E3779B9u;
+};
+
+#endif // PARTICLES_H
@@ -0,0 +1,65 @@
+#include "perfoverlay.h"
+
+#include <QPainter>
+
+namespace {
+const QRectF Panel(0, 0, 300, 200);
+const QRectF Graph(10, 130, 280, 60);
+const float GraphMaxMs = 33.3f;   // two 60 Hz frames tall
+const char* KindNames[KindCount] = { "planes", "helis", "falling", "troops", "bullets" };
+}
+
+PerfOverlay::PerfOverlay(const GameWorld* world, const ParticleSystem* particles)
+    : world(world), particles(particles) {
+    setZValue(10);
+    setPos(WIDTH - Panel.width() - 10, 10);
+}
+
+void PerfOverlay::record(double updateTime, double renderTime) {
+    updateMs[cursor] = float(updateTime);
+    renderMs[cursor] = float(renderTime);
+    cursor = (cursor + 1) % History;
+    QGraphicsItem::update();
+}
+
+void PerfOverlay::setStatus(const QString& text) {
+    status = text;
+}
+
+QRectF PerfOverlay::boundingRect() const {
+    return Panel;
+}
+
+void PerfOverlay::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*) {
+    painter->fillRect(Panel, QColor(0, 0, 0, 170));
+
+    int counts[KindCount] = {};
+    const EntityStore& es = world->entities();
+    for (int i = 0; i < es.size(); ++i) counts[es.kind[i]]++;
+
+    QString text = QString("%1   queued %2\n").arg(world->waveName()).arg(world->queuedSpawns());
+    for (int k = 0; k < KindCount; ++k)
+        text += QString("%1 %2   ").arg(KindNames[k]).arg(counts[k]);
+    text += QString("\nentities %1   particles %2\n").arg(es.size()).arg(particles->size()) + status;
+    painter->setPen(Qt::white);
+    painter->setFont(QFont("Monospace", 8));
+    painter->drawText(Panel.adjusted(8, 6, -8, -75), Qt::TextWordWrap, text);
+
+    // Update stacked under render, one column per frame, oldest on the left
+    painter->fillRect(Graph, QColor(255, 255, 255, 25));
+    float column = float(Graph.width()) / History;
+    float scale = float(Graph.height()) / GraphMaxMs;
+    for (int n = 0; n < History; ++n) {
+        int i = (cursor + n) % History;
+        float x = float(Graph.left()) + n * column;
+        float u = qMin(updateMs[i] * scale, float(Graph.height()));
+        float r = qMin(renderMs[i] * scale, float(Graph.height()) - u);
+        painter->fillRect(QRectF(x, Graph.bottom() - u, column, u), QColor(80, 220, 120));
+        painter->fillRect(QRectF(x, Graph.bottom() - u - r, column, r), QColor(255, 160, 40));
+    }
+    float budget = float(Graph.bottom()) - 16.7f * scale;
+    painter->setPen(QColor(255, 80, 80));
+    painter->drawLine(QPointF(Graph.left(), budget), QPointF(Graph.right(), budget));
+    painter->setPen(Qt::white);
+    painter->drawText(QPointF(Graph.left(), Graph.top() - 3), "update / render ms, 16.7 ms line");
+}
@@ -0,0 +1,35 @@
+#ifndef PERFOVERLAY_H
+#define PERFOVERLAY_H
+
+#include <QGraphicsItem>
+#include <QString>
+
+#include "particles.h"
+#include "world.h"
+
+// Corner panel for load testing: live entity counts by kind, the director's
+// queue, a status block from the scene and a graph of the last couple of
+// seconds of update and render time per frame against the 60 Hz budget.
+class PerfOverlay : public QGraphicsItem {
+public:
+    PerfOverlay(const GameWorld* world, const ParticleSystem* particles);
+
+    // One frame's timings; repaints just the panel
+    void record(double updateMs, double renderMs);
+    void setStatus(const QString& text);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+    enum { History = 150 };
+
+    const GameWorld* world;
+    const ParticleSystem* particles;
+    QString status;
+    float updateMs[History] = {};
+    float renderMs[History] = {};
+    int cursor = 0;
+};
+
+#endif // PERFOVERLAY_H
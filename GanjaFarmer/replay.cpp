@@ -0,0 +1,156 @@
+#include "replay.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+const char Magic[4] = { 'G', 'F', 'R', 'P' };
+const int HeaderSize = 4 + 2 + 4 + 4 + 4 + 8 + 4;
+
+template <typename T>
+void put(QByteArray& out, T value) {
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+bool take(const QByteArray& in, int& pos, T* value) {
+    if (pos + int(sizeof(T)) > in.size()) return false;
+    *value = qFromLittleEndian<T>(in.constData() + pos);
+    pos += sizeof(T);
+    return true;
+}
+
+// Floats go through their bit pattern so the angle reloads bit-for-bit
+void putFloat(QByteArray& out, float value) {
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    put<quint32>(out, bits);
+}
+
+bool takeFloat(const QByteArray& in, int& pos, float* value) {
+    quint32 bits;
+    if (!take(in, pos, &bits)) return false;
+    std::memcpy(value, &bits, sizeof bits);
+    return true;
+}
+
+void putVarint(QByteArray& out, quint64 v) {
+    while (v >= 0x80) {
+        out.append(char(v | 0x80));
+        v >>= 7;
+    }
+    out.append(char(v));
+}
+
+bool takeVarint(const QByteArray& in, int& pos, quint64* v) {
+    *v = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        quint8 byte = quint8(in[pos++]);
+        *v |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+}
+
+void Replay::append(const InputEvent& e) {
+    if (e.type == InputEvent::Aim && !events.isEmpty()) {
+        InputEvent& last = events.last();
+        if (last.type == InputEvent::Aim && last.tick == e.tick) {
+            last.angle = e.angle;
+            return;
+        }
+    }
+    events << e;
+}
+
+bool saveReplay(const QString& path, const Replay& replay, QString* error) {
+    QByteArray data;
+    data.reserve(HeaderSize + replay.events.size() * 2);
+    data.append(Magic, 4);
+    put<quint16>(data, ReplayVersion);
+    put<quint32>(data, replay.seed);
+    put<quint32>(data, replay.waves);
+    put<qint32>(data, replay.stress);
+    put<quint64>(data, replay.endTick);
+    put<quint32>(data, quint32(replay.events.size()));
+    quint32 tick = 0;
+    for (const InputEvent& e : replay.events) {
+        bool aim = e.type == InputEvent::Aim;
+        putVarint(data, (quint64(e.tick - tick) << 1) | (aim ? 1 : 0));
+        if (aim) putFloat(data, e.angle);
+        tick = e.tick;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool loadReplay(const QString& path, Replay& replay, QString* error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    QByteArray data = file.readAll();
+    if (data.size() < HeaderSize || !data.startsWith(QByteArray(Magic, 4))) {
+        if (error) *error = "Not a GanjaFarmer replay";
+        return false;
+    }
+
+    Replay loaded;
+    int pos = 4;
+    quint16 version;
+    quint32 count;
+    take(data, pos, &version);
+    take(data, pos, &loaded.seed);
+    take(data, pos, &loaded.waves);
+    take(data, pos, &loaded.stress);
+    take(data, pos, &loaded.endTick);
+    take(data, pos, &count);
+    if (version != ReplayVersion) {
+        if (error) *error = QString("Replay version %1 needs a matching build (this one plays %2)").arg(version).arg(ReplayVersion);
+        return false;
+    }
+
+    // Every event takes at least a byte, which bounds a corrupt count
+    if (count > quint32(data.size() - pos)) {
+        if (error) *error = "Replay is truncated";
+        return false;
+    }
+    loaded.events.reserve(int(count));
+    quint64 tick = 0;
+    for (quint32 i = 0; i < count; ++i) {
+        quint64 word;
+        InputEvent e;
+        if (!takeVarint(data, pos, &word)) break;
+        tick += word >> 1;
+        e.tick = quint32(tick);
+        if (word & 1) {
+            e.type = InputEvent::Aim;
+            if (!takeFloat(data, pos, &e.angle)) break;
+        } else {
+            e.type = InputEvent::Fire;
+        }
+        loaded.events << e;
+    }
+    if (loaded.events.size() != int(count)) {
+        if (error) *error = QString("Replay is truncated: expected %1 events, found %2").arg(count).arg(loaded.events.size());
+        return false;
+    }
+    replay = loaded;
+    return true;
+}
+
+bool isReplayFile(const QString& path) {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) && file.read(4) == QByteArray(Magic, 4);
+}
@@ -0,0 +1,37 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <QString>
+#include <QVector>
+
+#include "input.h"
+
+// A recorded session: everything GameWorld needs to play it out again
+// exactly. Replays only stay valid for the rules they were recorded with;
+// bump ReplayVersion when a rule change would make old ones diverge.
+//
+// File layout (little-endian):
+//   "GFRP" magic, quint16 version, quint32 seed, quint32 waves checksum,
+//   qint32 stress, quint64 end tick, quint32 event count, then the events.
+// Each event is a varint of (tick delta << 1 | isAim), followed for aims by
+// the angle as a float32. A shot is usually a single byte.
+const quint16 ReplayVersion = 2;
+
+struct Replay {
+    quint32 seed = 0;
+    quint32 waves = 0;     // checksum of the wave file it was played with
+    qint32 stress = 0;
+    quint64 endTick = 0;   // the world's tick when recording stopped
+    QVector<InputEvent> events;
+
+    // Appends in tick order. Aims with nothing else in between on the same
+    // tick collapse to the last one, since only that one can affect play.
+    void append(const InputEvent& e);
+};
+
+bool saveReplay(const QString& path, const Replay& replay, QString* error);
+bool loadReplay(const QString& path, Replay& replay, QString* error);
+// True if the file starts with the replay magic
+bool isReplayFile(const QString& path);
+
+#endif // REPLAY_H
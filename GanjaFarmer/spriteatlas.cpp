@@ -0,0 +1,103 @@
+#include "spriteatlas.h"
+
+#include <QPainter>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+struct SpriteSource {
+    const char* path;   // null for dots drawn here
+    QSize fit;          // scaled to fit, keeping aspect; empty keeps the original size
+    QRgb color;         // drawn dots only
+    bool soft;          // drawn dots: fade out from the centre
+};
+
+// Same sizes the scene used to scale to on every spawn
+const SpriteSource Sources[SpriteCount] = {
+    { ":/assets/images/airplane.png", QSize(90, 90), 0, false },
+    { ":/assets/images/helicopter.png", QSize(90, 90), 0, false },
+    { ":/assets/images/paratrooper.png", QSize(30, 30), 0, false },
+    { nullptr, QSize(4, 4), 0xffffff00, false },   // bullet
+    { ":/assets/images/turret_base.png", QSize(), 0, false },
+    { ":/assets/images/turret_barrel.png", QSize(30, 30), 0, false },
+    { ":/assets/images/background.png", QSize(), 0, false },
+    { nullptr, QSize(6, 6), 0xfffff2a0, true },    // spark
+    { nullptr, QSize(8, 8), 0xffff7a1a, true },    // ember
+    { nullptr, QSize(12, 12), 0xc0707070, true },  // smoke
+};
+
+const int SheetWidth = 1024;
+const int Padding = 2;   // keeps smooth scaling from bleeding between neighbours
+}
+
+AtlasImage SpriteAtlas::build() {
+    QElapsedTimer clock;
+    clock.start();
+
+    QImage images[SpriteCount];
+    for (int s = 0; s < SpriteCount; ++s) {
+        const SpriteSource& src = Sources[s];
+        if (!src.path) {
+            images[s] = QImage(src.fit, QImage::Format_ARGB32_Premultiplied);
+            images[s].fill(Qt::transparent);
+            QPainter p(&images[s]);
+            p.setRenderHint(QPainter::Antialiasing);
+            p.setPen(Qt::NoPen);
+            QRectF r(QPointF(0, 0), src.fit);
+            QColor c = QColor::fromRgba(src.color);
+            if (src.soft) {
+                QRadialGradient glow(r.center(), r.width() / 2);
+                glow.setColorAt(0, c);
+                c.setAlpha(0);
+                glow.setColorAt(1, c);
+                p.setBrush(glow);
+            } else {
+                p.setBrush(c);
+            }
+            p.drawEllipse(r);
+            continue;
+        }
+        QImage image(src.path);
+        if (!src.fit.isEmpty())
+            image = image.scaled(src.fit, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        images[s] = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    // Shelf packing: left to right, a new row when the current one is full
+    AtlasImage result;
+    int x = 0, y = 0, rowHeight = 0;
+    for (int s = 0; s < SpriteCount; ++s) {
+        QSize size = images[s].size();
+        if (x + size.width() > SheetWidth) {
+            x = 0;
+            y += rowHeight + Padding;
+            rowHeight = 0;
+        }
+        result.rects[s] = QRect(QPoint(x, y), size);
+        x += size.width() + Padding;
+        rowHeight = qMax(rowHeight, size.height());
+    }
+
+    result.sheet = QImage(SheetWidth, y + rowHeight, QImage::Format_ARGB32_Premultiplied);
+    result.sheet.fill(Qt::transparent);
+    QPainter p(&result.sheet);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    for (int s = 0; s < SpriteCount; ++s)
+        p.drawImage(result.rects[s].topLeft(), images[s]);
+    p.end();
+
+    result.buildMs = clock.elapsed();
+    return result;
+}
+
+QFuture<AtlasImage> SpriteAtlas::buildAsync() {
+    return QtConcurrent::run(&SpriteAtlas::build);
+}
+
+void SpriteAtlas::upload(const AtlasImage& image) {
+    atlas = QPixmap::fromImage(image.sheet);
+    for (int s = 0; s < SpriteCount; ++s) {
+        rects[s] = image.rects[s];
+        pieces[s] = atlas.copy(rects[s]);
+    }
+}
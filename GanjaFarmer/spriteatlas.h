@@ -0,0 +1,53 @@
+#ifndef SPRITEATLAS_H
+#define SPRITEATLAS_H
+
+#include <QFuture>
+#include <QImage>
+#include <QPixmap>
+#include <QRect>
+
+enum Sprite {
+    SpritePlane,
+    SpriteHeli,
+    SpriteTrooper,
+    SpriteBullet,
+    SpriteTurretBase,
+    SpriteTurretBarrel,
+    SpriteBackground,
+    SpriteSpark,       // particle dots, pre-coloured since fragments can't be tinted
+    SpriteEmber,
+    SpriteSmoke,
+    SpriteCount
+};
+
+// Every game image decoded, scaled to its in-game size and packed into one
+// sheet. Building it is pure QImage work, so it runs on a worker thread.
+struct AtlasImage {
+    QImage sheet;
+    QRect rects[SpriteCount];
+    qint64 buildMs = 0;
+};
+
+// The GUI-thread side: the sheet as a QPixmap plus per-sprite lookups.
+// Nothing here decodes or scales once upload() has run.
+class SpriteAtlas {
+public:
+    static AtlasImage build();
+    static QFuture<AtlasImage> buildAsync();
+
+    // QPixmaps may only be made on the GUI thread, so this is the one step left there
+    void upload(const AtlasImage& image);
+
+    bool isReady() const { return !atlas.isNull(); }
+    const QPixmap& sheet() const { return atlas; }
+    QRect rect(Sprite s) const { return rects[s]; }
+    // A standalone pixmap for scene items; cut once, then shared
+    QPixmap pixmap(Sprite s) const { return pieces[s]; }
+
+private:
+    QPixmap atlas;
+    QRect rects[SpriteCount];
+    QPixmap pieces[SpriteCount];
+};
+
+#endif // SPRITEATLAS_H
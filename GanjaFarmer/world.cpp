@@ -0,0 +1,205 @@
+#include "world.h"
+
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+// Sprite sizes after scaling to fit 90x90 (aircraft) and 30x30 (troopers)
+const QSizeF KindSize[KindCount] = {
+    QSizeF(90, 29),   // KindPlane
+    QSizeF(90, 27),   // KindHeli
+    QSizeF(23, 30),   // KindFalling
+    QSizeF(23, 30),   // KindTroop
+    QSizeF(4, 4)      // KindBullet, drawn centred on its position
+};
+
+const QPointF MuzzleOffset(25, -15); // barrel tip relative to its pivot, unrotated
+const int InitialCapacity = 256;
+const float GridCell = 64;           // bigger than a bullet's step, smaller than an aircraft
+
+bool isTarget(quint8 kind) {
+    return kind == KindPlane || kind == KindHeli || kind == KindFalling;
+}
+}
+
+GameWorld::GameWorld(quint32 seed, const WaveSet& waves)
+    : grid(WIDTH, HEIGHT, GridCell), startSeed(seed), wavesSum(waves.checksum), rng(seed) {
+    director.start(waves, seed);
+    store.reserve(InitialCapacity);
+    hits.reserve(32);
+    drops.reserve(32);
+    pending.reserve(32);
+}
+
+QPointF GameWorld::turretPivot() const {
+    return QPointF(WIDTH / 2, HEIGHT - 85);
+}
+
+QPointF GameWorld::muzzle() const {
+    qreal r = qDegreesToRadians(angle);
+    qreal c = qCos(r), s = qSin(r);
+    return turretPivot() + QPointF(MuzzleOffset.x() * c - MuzzleOffset.y() * s,
+                                   MuzzleOffset.x() * s + MuzzleOffset.y() * c);
+}
+
+QRectF GameWorld::bounds(int i) const {
+    const QSizeF& size = KindSize[store.kind[i]];
+    if (store.kind[i] == KindBullet)
+        return QRectF(store.x[i] - size.width() / 2, store.y[i] - size.height() / 2, size.width(), size.height());
+    return QRectF(store.x[i], store.y[i], size.width(), size.height());
+}
+
+void GameWorld::emitEvent(WorldEvent::Type type, float x, float y) {
+    WorldEvent e;
+    e.type = type;
+    e.x = x;
+    e.y = y;
+    pending << e;
+}
+
+void GameWorld::step() {
+    tick++;
+    SpawnEvent due;
+    while (director.next(tick, due))
+        spawn(due);
+
+    // Integrate first as one flat pass, then apply the per-kind rules
+    const int n = store.size();
+    float* x = store.x.data();
+    float* y = store.y.data();
+    float* px = store.prevX.data();
+    float* py = store.prevY.data();
+    const float* vx = store.vx.constData();
+    const float* vy = store.vy.constData();
+    for (int i = 0; i < n; ++i) {
+        px[i] = x[i];
+        py[i] = y[i];
+        x[i] += vx[i];
+        y[i] += vy[i];
+    }
+
+    // Drops are spawned after the pass so the arrays don't grow under us
+    drops.clear();
+    for (int i = 0; i < n; ++i) {
+        switch (store.kind[i]) {
+        case KindPlane:
+        case KindHeli:
+            if (store.dropChance[i] > 0 && rng.generateDouble() < store.dropChance[i]) drops << QPointF(x[i], y[i]);
+            if (x[i] > WIDTH) store.dead[i] = 1;
+            break;
+        case KindFalling:
+            if (y[i] >= GROUND_Y) {
+                store.kind[i] = KindTroop;
+                store.vx[i] = STEP / 0.016; // 1 px per 16 ms
+                store.vy[i] = 0;
+            }
+            break;
+        case KindTroop:
+            if (x[i] > WIDTH) {
+                store.dead[i] = 1;
+                counters.score -= 10;
+                emitEvent(WorldEvent::TroopEscaped, x[i], y[i]);
+            }
+            break;
+        case KindBullet:
+            break;
+        }
+    }
+
+    collide();
+
+    // Only after collide(): the segment that carries a bullet out can still hit
+    for (int i = 0; i < n; ++i) {
+        if (store.kind[i] == KindBullet && (x[i] < 0 || x[i] > WIDTH || y[i] < 0 || y[i] > HEIGHT))
+            store.dead[i] = 1;
+    }
+
+    for (const QPointF& p : drops)
+        store.add(KindFalling, p.x(), p.y(), 0, 3 * STEP / 0.040); // falling speed
+    store.removeDead();
+    while (store.size() < stress)
+        spawnStressEntity();
+}
+
+// Targets go into the grid, then each bullet's path this tick is swept
+// against the boxes in the cells it crosses. All contacts are gathered first
+// and resolved earliest-first, so a bullet hits the nearest target and a
+// target can only be taken by one bullet.
+void GameWorld::collide() {
+    const int n = store.size();
+    grid.clear();
+    for (int i = 0; i < n; ++i)
+        if (!store.dead[i] && isTarget(store.kind[i])) grid.add(i, bounds(i));
+    grid.build();
+
+    const float r = KindSize[KindBullet].width() / 2;
+    hits.clear();
+    for (int b = 0; b < n; ++b) {
+        if (store.kind[b] != KindBullet || store.dead[b]) continue;
+        QPointF from(store.prevX[b], store.prevY[b]), to(store.x[b], store.y[b]);
+        QRectF path = QRectF(from, to).normalized().adjusted(-r, -r, r, r);
+        grid.visit(path, [&](int target, const QRectF& box) {
+            Hit h;
+            // Grow the box by the bullet radius so the bullet can be a point
+            if (segmentHitsBox(from, to, box.adjusted(-r, -r, r, r), &h.t)) {
+                h.bullet = b;
+                h.target = target;
+                hits << h;
+            }
+        });
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) { return a.t < b.t; });
+    for (const Hit& h : hits) {
+        if (store.dead[h.bullet] || store.dead[h.target]) continue;
+        store.dead[h.bullet] = 1;
+        store.dead[h.target] = 1;
+        QPointF at = bounds(h.target).center();
+        if (store.kind[h.target] == KindFalling) {
+            counters.kills++;
+            emitEvent(WorldEvent::TrooperKilled, at.x(), at.y());
+        } else {
+            counters.explosions++;
+            emitEvent(WorldEvent::Explosion, at.x(), at.y());
+        }
+    }
+}
+
+void GameWorld::spawn(const SpawnEvent& e) {
+    // Groups from an earlier wave can still be spawning; the level only rises
+    if (e.level > counters.level) {
+        counters.level = e.level;
+        emitEvent(WorldEvent::LevelUp, 0, 0);
+    }
+    store.add(EntityKind(e.kind), e.x, e.y, e.vx, e.vy, e.dropChance);
+}
+
+// Scattered over the whole field so a stress run is on screen at once.
+// Draws are taken one per statement: argument evaluation order would
+// otherwise make the sequence compiler-dependent.
+void GameWorld::spawnStressEntity() {
+    if (rng.bounded(4) == 0) {
+        EntityKind kind = rng.bounded(2) ? KindPlane : KindHeli;
+        int x = rng.bounded(WIDTH);
+        int y = rng.bounded(200) + 30;
+        store.add(kind, x, y, counters.level * STEP / 0.040, 0);
+    } else {
+        int x = rng.bounded(WIDTH);
+        int y = rng.bounded(GROUND_Y);
+        store.add(KindFalling, x, y, 0, 3 * STEP / 0.040);
+    }
+}
+
+void GameWorld::apply(const InputEvent& input) {
+    if (input.type == InputEvent::Aim) aim(input.angle);
+    else fire();
+}
+
+void GameWorld::fire() {
+    // Fly along the barrel angle at the time of firing, 10 px per 16 ms
+    qreal r = qDegreesToRadians(angle);
+    QPointF tip = muzzle();
+    QPointF vel = QPointF(qCos(r), qSin(r)) * 10 * (STEP / 0.016);
+    store.add(KindBullet, tip.x(), tip.y(), vel.x(), vel.y());
+    emitEvent(WorldEvent::Shot, tip.x(), tip.y());
+}
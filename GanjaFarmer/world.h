@@ -0,0 +1,86 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <QPointF>
+#include <QRandomGenerator>
+#include <QRectF>
+#include <QVector>
+
+#include "collision.h"
+#include "director.h"
+#include "entities.h"
+#include "input.h"
+
+const int WIDTH = 800, HEIGHT = 600;
+const int TURRET_LIMIT = 45;
+const double STEP = 1.0 / 60.0;   // fixed simulation tick, seconds
+const int GROUND_Y = HEIGHT - 100;
+
+// Something the presentation side should react to (sound, HUD, effects)
+struct WorldEvent {
+    enum Type : quint8 { Shot, Explosion, TrooperKilled, TroopEscaped, LevelUp };
+    Type type;
+    float x, y;
+};
+
+struct GameStats {
+    int score = 0, kills = 0, explosions = 0, level = 1;
+};
+
+// The game rules, with no scene, items or timers. The scene feeds it input,
+// calls step() once per fixed tick and draws whatever is in entities().
+// All randomness comes from one generator seeded here, so the same seed,
+// waves and input on the same ticks always play out the same game.
+class GameWorld {
+public:
+    explicit GameWorld(quint32 seed = 1, const WaveSet& waves = defaultWaves());
+
+    void step();
+    // Barrel rotation in scene degrees (0 points right, negative is up)
+    void aim(qreal degrees) { angle = degrees; }
+    void fire();
+    void apply(const InputEvent& input);
+    // Tops the world up to at least n entities every tick, for render and
+    // collision load tests; 0 is normal play
+    void setStressLevel(int n) { stress = n; }
+    int stressLevel() const { return stress; }
+
+    qreal turretAngle() const { return angle; }
+    QPointF turretPivot() const;
+    QPointF muzzle() const;
+
+    const EntityStore& entities() const { return store; }
+    // Hit box of entity i, matching its drawn sprite
+    QRectF bounds(int i) const;
+    const GameStats& stats() const { return counters; }
+    quint64 ticks() const { return tick; }
+    quint32 seed() const { return startSeed; }
+    quint32 wavesChecksum() const { return wavesSum; }
+    QString waveName() const { return director.waveName(); }
+    int queuedSpawns() const { return director.queued(); }
+
+    // Events since the last clearEvents(); the scene drains them after stepping
+    const QVector<WorldEvent>& events() const { return pending; }
+    void clearEvents() { pending.clear(); }
+
+private:
+    void spawn(const SpawnEvent& e);
+    void spawnStressEntity();
+    void collide();
+    void emitEvent(WorldEvent::Type type, float x, float y);
+
+    EntityStore store;
+    CollisionGrid grid;
+    WaveDirector director;
+    QVector<Hit> hits;        // reused every tick
+    QVector<QPointF> drops;   // reused every tick
+    QVector<WorldEvent> pending;
+    GameStats counters;
+    quint32 startSeed, wavesSum;
+    QRandomGenerator rng;
+    qreal angle = 0;
+    quint64 tick = 0;
+    int stress = 0;
+};
+
+#endif // WORLD_H
@@ -0,0 +1,17 @@
+QT       += core gui sql concurrent testlib
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = planter-bench
+
+# Benchmarks only mean something against an optimized build
+CONFIG -= debug
+CONFIG += release
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    benchmarks.cpp
+
+include(../core/core.pri)
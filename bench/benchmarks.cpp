@@ -0,0 +1,430 @@
+// Microbenchmarks for the hot paths shared by the PlantER apps:
+// SunSet (flowerTime's calendar colours every visible day with it), the
+// GardenDemo schedule check and plant list query, telemetry writes, adaptive
+// watering, event logging, the dashboard's chart series, and 420Grower's
+// daily step and console.
+//
+// Runs as a normal QTest binary, so the usual options (-iterations,
+// -minimumvalue, -tickcounter, function names) work. Results are also written
+// as JSON, to bench.json or the file given with --json <file>.
+
+#include <QtTest>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QXmlStreamReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTemporaryFile>
+
+#include "adaptivewatering.h"
+#include "eventlog.h"
+#include "gardendb.h"
+#include "gardenset.h"
+#include "logbuffer.h"
+#include "minmaxpyramid.h"
+#include "plantindex.h"
+#include "schedule.h"
+#include "sunset.h"
+#include "simulation.h"
+#include "telemetry.h"
+#include "telemetrysources.h"
+
+namespace {
+// Edmonton, the city flowerTime ships with
+const double Latitude = 53.5344;
+const double Longitude = -113.4903;
+const int TzOffset = -7;
+
+// One in-memory garden per row count, built on first use and kept for the run
+QSqlDatabase gardenWithRows(int rows) {
+    const QString name = QString("bench-%1").arg(rows);
+    if (QSqlDatabase::contains(name)) return QSqlDatabase::database(name);
+    openGardenDb(":memory:", name);
+    QSqlDatabase db = QSqlDatabase::database(name);
+
+    db.transaction();
+    QSqlQuery tent(db);
+    tent.prepare("INSERT INTO tents (name, feed2x, feed1, feed2, water_days, feed_days, sound) VALUES (?, ?, ?, ?, ?, ?, '')");
+    QSqlQuery plant(db);
+    plant.prepare("INSERT INTO plants (name, tent_id, flower_time_days, start_date) VALUES (?, ?, 60, '2025-01-01')");
+    for (int i = 0; i < rows; ++i) {
+        QTime feed1 = QTime(0, 0).addSecs(60 * (i % 1440));
+        tent.addBindValue(QString("Tent %1").arg(i));
+        tent.addBindValue(i % 2);
+        tent.addBindValue(feed1.toString("HH:mm"));
+        tent.addBindValue(feed1.addSecs(9 * 3600).toString("HH:mm"));
+        tent.addBindValue(QString::number(i % 128, 2).rightJustified(7, '0'));
+        tent.addBindValue(QString::number((i * 37) % 128, 2).rightJustified(7, '0'));
+        if (!tent.exec()) qWarning() << "tent insert:" << tent.lastError().text();
+
+        // Every tenth plant is unassigned, so the LEFT JOIN has misses to handle
+        plant.addBindValue(QString("Plant %1").arg(i));
+        plant.addBindValue(i % 10 == 9 ? 0 : i % rows + 1);
+        if (!plant.exec()) qWarning() << "plant insert:" << plant.lastError().text();
+    }
+    db.commit();
+    return db;
+}
+
+void addRowCounts() {
+    QTest::addColumn<int>("rows");
+    QTest::newRow("10") << 10;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("100000") << 100000;
+}
+}
+
+class Benchmarks : public QObject {
+    Q_OBJECT
+
+    double sink = 0; // results land here so the optimizer can't drop the work
+
+private slots:
+    void sunriseDay() {
+        SunSet sun(Latitude, Longitude, TzOffset);
+        sun.setCurrentDate(2025, 6, 21);
+        QBENCHMARK { sink += sun.calcSunrise(); }
+    }
+
+    void sunsetDay() {
+        SunSet sun(Latitude, Longitude, TzOffset);
+        sun.setCurrentDate(2025, 6, 21);
+        QBENCHMARK { sink += sun.calcSunset(); }
+    }
+
+    // A full year of sunrise and sunset, setting the date each day as the calendar does
+    void sunYear() {
+        QVector<QDate> days;
+        for (QDate d(2025, 1, 1); d.year() == 2025; d = d.addDays(1)) days.append(d);
+        SunSet sun(Latitude, Longitude, TzOffset);
+        QBENCHMARK {
+            for (const QDate& d : days) {
+                sun.setCurrentDate(d.year(), d.month(), d.day());
+                sink += sun.calcSunset() - sun.calcSunrise();
+            }
+        }
+    }
+
+    void scheduleCheck_data() { addRowCounts(); }
+    // What GardenDemo's timer does each minute: read every tent and evaluate it
+    void scheduleCheck() {
+        QFETCH(int, rows);
+        QSqlDatabase db = gardenWithRows(rows);
+        const QDateTime now(QDate(2025, 6, 22), QTime(9, 0));
+        QBENCHMARK { sink += dueAlerts(loadTentSchedules(db), now).size(); }
+    }
+
+    void scheduleEvaluate_data() { addRowCounts(); }
+    // The schedule rules alone, without the query
+    void scheduleEvaluate() {
+        QFETCH(int, rows);
+        const QVector<TentSchedule> tents = loadTentSchedules(gardenWithRows(rows));
+        QCOMPARE(tents.size(), rows);
+        const QDateTime now(QDate(2025, 6, 22), QTime(9, 0));
+        QBENCHMARK { sink += dueAlerts(tents, now).size(); }
+    }
+
+    void scheduleQueue_data() { addRowCounts(); }
+    // gardend's engine: build the queue and pop a whole day of alerts in due order
+    void scheduleQueue() {
+        QFETCH(int, rows);
+        const QVector<TentSchedule> tents = loadTentSchedules(gardenWithRows(rows));
+        const QDateTime from(QDate(2025, 6, 22), QTime(0, 0));
+        ScheduleQueue queue;
+        QBENCHMARK {
+            queue.reset(tents, from);
+            sink += queue.takeDue(from.addDays(1)).size();
+        }
+    }
+
+    void loadPlants_data() { addRowCounts(); }
+    void loadPlants() {
+        QFETCH(int, rows);
+        QSqlDatabase db = gardenWithRows(rows);
+        QBENCHMARK { sink += loadPlantRows(db).size(); }
+    }
+
+    void plantSearch_data() {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<int>("stage");
+        QTest::newRow("everything") << QString() << -1;
+        QTest::newRow("one plant") << QString("plant 4242") << -1;
+        QTest::newRow("prefixes") << QString("t 9") << -1;
+        QTest::newRow("flowering") << QString("tent") << int(PlantStage::Flowering);
+    }
+    // GardenDemo's plant search at 100000 plants, for the 500 matches the
+    // list shows and the count of the rest
+    void plantSearch() {
+        QFETCH(QString, text);
+        QFETCH(int, stage);
+        PlantIndex index;
+        index.reset(loadPlantRows(gardenWithRows(100000)));
+        PlantQuery query;
+        query.text = text;
+        query.stage = stage;
+        query.today = QDate(2025, 3, 1);
+        int total = 0;
+        QBENCHMARK { sink += index.search(query, 500, &total).size(); }
+        sink += total;
+    }
+
+    // GardenDemo's "Harvests This Week" over eight gardens of 10000 plants,
+    // one pool thread per garden database
+    void gardenHarvests() {
+        QTemporaryDir dir;
+        GardenSet gardens(dir.filePath("garden_demo.db"), dir.filePath("gardens"));
+        for (int g = 0; g < 8; ++g) {
+            const QString name = QString("garden %1").arg(g);
+            QString error;
+            QVERIFY2(gardens.create(name, &error), qPrintable(error));
+            {
+                QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "bench-garden");
+                db.setDatabaseName(gardens.garden(name).path);
+                QVERIFY(db.open());
+                db.transaction();
+                QSqlQuery plant(db);
+                plant.prepare("INSERT INTO plants (name, tent_id, flower_time_days, start_date) VALUES (?, 0, 60, ?)");
+                for (int i = 0; i < 10000; ++i) {
+                    plant.addBindValue(QString("Plant %1").arg(i));
+                    plant.addBindValue(QDate(2025, 1, 1).addDays(i % 365).toString("yyyy-MM-dd"));
+                    plant.exec();
+                }
+                db.commit();
+                db.close();
+            }
+            QSqlDatabase::removeDatabase("bench-garden");
+        }
+        const QDate from(2025, 6, 1);
+        QBENCHMARK { sink += gardens.harvests(from, from.addDays(6)).result().size(); }
+    }
+
+    // One writer batch into a file-backed store, rollups included:
+    // readings per second is 5000 over the time per iteration
+    void telemetryAppend() {
+        QTemporaryDir dir;
+        TelemetryStore store("bench-telemetry");
+        QVERIFY2(store.open(dir.filePath("telemetry.db")), qPrintable(store.errorString()));
+        SimulatedTelemetrySource sensors(16, 10000);
+        qint64 now = QDateTime(QDate(2025, 6, 22), QTime(0, 0)).toMSecsSinceEpoch();
+        QBENCHMARK {
+            QVector<Reading> batch = sensors.generate(5000, now);
+            now += 500;
+            QVERIFY(store.append(batch));
+        }
+        sink += store.rollups(1, Sensor::Temperature, RollupSize::Minute, 0, now + 1).size();
+    }
+
+    // gardend's work per burst of moisture readings, one for each of 1000
+    // adaptive tents: fold them into the trends and requeue the predictions
+    void adaptiveUpdate() {
+        const int tentCount = 1000;
+        QVector<TentSchedule> tents;
+        for (int i = 1; i <= tentCount; ++i) {
+            TentSchedule t;
+            t.id = i;
+            t.name = QString("Tent %1").arg(i);
+            t.feed1 = "09:00";
+            t.waterDays = "1111111";
+            t.feedDays = "0000000";
+            t.adaptive = true;
+            tents.append(t);
+        }
+        const QDateTime from(QDate(2025, 6, 22), QTime(0, 0));
+        ScheduleQueue queue;
+        queue.reset(tents, from);
+        AdaptiveWatering adaptive;
+        adaptive.setTents(tents);
+
+        QVector<Reading> burst(tentCount);
+        for (int i = 0; i < tentCount; ++i) {
+            burst[i].tent = i + 1;
+            burst[i].sensor = Sensor::Moisture;
+        }
+        qint64 now = from.toMSecsSinceEpoch();
+        float moisture = 0.8f;
+        auto nextBurst = [&]() {
+            now += 10000;
+            moisture -= 0.00005f; // about 0.018 an hour
+            for (int i = 0; i < tentCount; ++i) {
+                burst[i].time = now;
+                burst[i].value = moisture + 0.001f * (i % 7);
+            }
+        };
+        // Enough history that every tent has a prediction
+        for (int i = 0; i < 200; ++i) {
+            nextBurst();
+            adaptive.update(burst, now);
+        }
+        QBENCHMARK {
+            nextBurst();
+            for (const WateringPrediction& p : adaptive.update(burst, now)) {
+                queue.setPrediction(p.tentId, p.live, p.due);
+                sink += p.due > 0;
+            }
+        }
+    }
+
+    // What logging adds to the alert path: the caller's side of EventLog::record
+    void eventRecord() {
+        QTemporaryDir dir;
+        EventLog events;
+        QString error;
+        QVERIFY2(events.open(dir.filePath("events.db"), &error), qPrintable(error));
+        int tent = 0;
+        QBENCHMARK { events.record(GardenEventKind::Alert, ++tent % 100 + 1, "Water", "Tent"); }
+        sink += events.dropped() + 1;
+    }
+
+    // A year of minute readings, as the dashboard holds for each sensor
+    void pyramidAppend() {
+        const qint64 start = QDateTime(QDate(2025, 1, 1), QTime(0, 0)).toMSecsSinceEpoch();
+        QBENCHMARK {
+            MinMaxPyramid series;
+            for (int i = 0; i < 365 * 1440; ++i)
+                series.append(start + i * 60000LL, float(i % 1440) / 1440);
+            sink += series.size();
+        }
+    }
+
+    void pyramidColumns_data() {
+        QTest::addColumn<int>("days");
+        QTest::newRow("year") << 365;
+        QTest::newRow("week") << 7;
+        QTest::newRow("hour") << 0;
+    }
+    // One 1000 pixel wide chart of that year, zoomed to the given span
+    void pyramidColumns() {
+        QFETCH(int, days);
+        const qint64 start = QDateTime(QDate(2025, 1, 1), QTime(0, 0)).toMSecsSinceEpoch();
+        MinMaxPyramid series;
+        for (int i = 0; i < 365 * 1440; ++i)
+            series.append(start + i * 60000LL, float(i % 1440) / 1440);
+        const qint64 from = start + 180 * 86400000LL;
+        const qint64 to = from + (days ? days * 86400000LL : 3600000LL);
+        QBENCHMARK { sink += series.columns(from, to, 1000).first().hi; }
+    }
+
+    void logAppend_data() {
+        QTest::addColumn<bool>("filtered");
+        QTest::newRow("all") << false;
+        QTest::newRow("filtered") << true;
+    }
+    // A second of 420Grower's console at 100000 messages a second: the
+    // appends, then the one model refresh the view would do for them
+    void logAppend() {
+        QFETCH(bool, filtered);
+        LogBuffer buffer;
+        LogModel model(&buffer);
+        if (filtered) {
+            LogFilter filter;
+            filter.text = "plant 7";
+            model.setFilter(filter);
+        }
+        const QString text = QStringLiteral("Watered plant %1");
+        int n = 0;
+        QBENCHMARK {
+            for (int i = 0; i < 100000; ++i, ++n)
+                buffer.append(i % 50 ? LogSeverity::Info : LogSeverity::Warning, n % 1000, 1, text.arg(n % 1000));
+            model.refresh();
+        }
+        sink += model.rowCount();
+    }
+
+    void populationStep_data() { addRowCounts(); }
+    // One day of stepGarden; 100000 plants crosses the threshold where it goes parallel
+    void populationStep() {
+        QFETCH(int, rows);
+        QList<Plant> plants;
+        plants.reserve(rows);
+        for (int i = 0; i < rows; ++i) {
+            Plant p;
+            p.seed = quint32(i) * 2654435761u;
+            plants.append(p);
+        }
+        int day = 0;
+        QBENCHMARK { stepGarden(plants, day++); }
+        sink += plants.first().health;
+    }
+
+    void cleanupTestCase() {
+        QVERIFY(sink != 0);
+    }
+};
+
+// QTest's XML log carries every BenchmarkResult (value is per iteration);
+// flatten those into one JSON document.
+bool writeJson(QIODevice* xml, const QString& path, int status) {
+    QJsonArray results;
+    QString function;
+    QXmlStreamReader reader(xml);
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement) continue;
+        QXmlStreamAttributes a = reader.attributes();
+        if (reader.name() == "TestFunction") {
+            function = a.value("name").toString();
+        } else if (reader.name() == "BenchmarkResult") {
+            QJsonObject r;
+            r["name"] = function;
+            r["tag"] = a.value("tag").toString();
+            r["metric"] = a.value("metric").toString();
+            r["value"] = a.value("value").toDouble();
+            r["iterations"] = a.value("iterations").toInt();
+            results.append(r);
+        }
+    }
+    if (reader.hasError()) {
+        qWarning() << "Could not read the benchmark log:" << reader.errorString();
+        return false;
+    }
+
+    QJsonObject doc;
+    doc["format"] = "planter-bench";
+    doc["version"] = 1;
+    doc["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    doc["qt"] = qVersion();
+    doc["os"] = QSysInfo::prettyProductName();
+    doc["cpu"] = QSysInfo::currentCpuArchitecture();
+    doc["passed"] = status == 0;
+    doc["results"] = results;
+
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write" << path << ":" << out.errorString();
+        return false;
+    }
+    out.write(QJsonDocument(doc).toJson());
+    return out.commit();
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    // --json is ours; everything else goes to QTest
+    QStringList args = app.arguments();
+    QString jsonPath = "bench.json";
+    int at = args.indexOf("--json");
+    if (at > 0 && at + 1 < args.size()) {
+        jsonPath = args.at(at + 1);
+        args.erase(args.begin() + at, args.begin() + at + 2);
+    }
+
+    QTemporaryFile xml;
+    if (!xml.open()) {
+        qWarning() << "Could not create a temporary file:" << xml.errorString();
+        return 1;
+    }
+    xml.close();
+    args << "-o" << xml.fileName() + ",xml" << "-o" << "-,txt";
+
+    Benchmarks benchmarks;
+    int status = QTest::qExec(&benchmarks, args);
+
+    if (!xml.open() || !writeJson(&xml, jsonPath, status)) return status ? status : 1;
+    return status;
+}
+
+#include "benchmarks.moc"
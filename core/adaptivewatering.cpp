@@ -0,0 +1,142 @@
+#include "adaptivewatering.h"
+
+#include <cmath>
+
+namespace {
+const double MsPerHour = 3600.0 * 1000.0;
+const double HalfLifeHours = 6.0;
+// A rise bigger than sensor noise means someone watered
+const double WateringJump = 0.05;
+// Don't extrapolate from a handful of points or a few minutes of data
+const int MinSamples = 8;
+const qint64 MinSpanMs = 30 * 60 * 1000;
+const qint64 MaxLateMs = 60 * 1000;
+// Predictions further out than this aren't worth queuing
+const qint64 MaxHorizonMs = 14LL * 24 * 3600 * 1000;
+// A tent with no moisture reading for this long goes back to its calendar
+const qint64 StaleAfterMs = 6LL * 3600 * 1000;
+}
+
+void MoistureTrend::add(qint64 time, double moisture) {
+    // A little out of order (two sources, or a seeded minute) is just skipped
+    if (n > 0 && time < last && last - time <= MaxLateMs) return;
+    // Watered, or the clock went backwards: either way the old curve is done
+    if (n > 0 && (moisture - lastMoisture > WateringJump || time < last)) reset();
+    if (n == 0) {
+        origin = first = time;
+    } else {
+        double decay = std::exp2(-(time - last) / (HalfLifeHours * MsPerHour));
+        sw *= decay;
+        sx *= decay;
+        sy *= decay;
+        sxx *= decay;
+        sxy *= decay;
+    }
+    double x = (time - origin) / MsPerHour;
+    sw += 1;
+    sx += x;
+    sy += moisture;
+    sxx += x * x;
+    sxy += x * moisture;
+    n++;
+    last = time;
+    lastMoisture = moisture;
+}
+
+void MoistureTrend::reset() {
+    *this = MoistureTrend();
+}
+
+double MoistureTrend::slopePerHour() const {
+    double denom = sw * sxx - sx * sx;
+    return denom > 1e-12 ? (sw * sxy - sx * sy) / denom : 0.0;
+}
+
+bool MoistureTrend::canPredict() const {
+    return n >= MinSamples && last - first >= MinSpanMs;
+}
+
+qint64 MoistureTrend::predictCrossing(double threshold) const {
+    if (!canPredict()) return -1;
+    if (lastMoisture <= threshold) return last;
+    double slope = slopePerHour();
+    if (slope >= -1e-6) return -1;
+    double intercept = (sy - slope * sx) / sw;
+    qint64 at = origin + qint64((threshold - intercept) / slope * MsPerHour);
+    if (at <= last) return last; // the fit says it is there already
+    if (at - last > MaxHorizonMs) return -1;
+    return at;
+}
+
+void AdaptiveWatering::setTents(const QVector<TentSchedule>& schedules) {
+    QHash<int, Tent> next;
+    for (const TentSchedule& s : schedules) {
+        if (!s.adaptive) continue;
+        Tent t = tents.value(s.id);
+        t.threshold = s.moistureThreshold;
+        t.touched = false;
+        next.insert(s.id, t);
+    }
+    tents.swap(next);
+    touched.clear();
+}
+
+bool AdaptiveWatering::hasTrend(int tentId) const {
+    auto it = tents.constFind(tentId);
+    return it != tents.constEnd() && it->trend.samples() > 0;
+}
+
+void AdaptiveWatering::seed(int tentId, const QVector<Rollup>& minutes) {
+    auto it = tents.find(tentId);
+    if (it == tents.end()) return;
+    for (const Rollup& r : minutes)
+        it->trend.add(r.bucket + 30000, r.mean()); // the middle of the minute
+}
+
+QVector<WateringPrediction> AdaptiveWatering::update(const QVector<Reading>& batch, qint64 now) {
+    for (const Reading& r : batch) {
+        if (r.sensor != Sensor::Moisture) continue;
+        auto it = tents.find(r.tent);
+        if (it == tents.end()) continue;
+        it->trend.add(r.time, r.value);
+        if (!it->touched) {
+            it->touched = true;
+            touched.append(r.tent);
+        }
+    }
+    QVector<WateringPrediction> out;
+    out.reserve(touched.size());
+    for (int id : touched) {
+        Tent& t = tents[id];
+        t.touched = false;
+        out.append(predict(id, t, now));
+        t.live = out.last().live;
+    }
+    touched.clear();
+    return out;
+}
+
+QVector<WateringPrediction> AdaptiveWatering::predictions(qint64 now) {
+    QVector<WateringPrediction> out;
+    out.reserve(tents.size());
+    for (auto it = tents.begin(); it != tents.end(); ++it) {
+        out.append(predict(it.key(), *it, now));
+        it->live = out.last().live;
+    }
+    return out;
+}
+
+QVector<WateringPrediction> AdaptiveWatering::expire(qint64 now) {
+    QVector<WateringPrediction> out;
+    for (auto it = tents.begin(); it != tents.end(); ++it) {
+        if (!it->live || now - it->trend.lastTime() < StaleAfterMs) continue;
+        it->live = false;
+        out.append({it.key(), false, -1});
+    }
+    return out;
+}
+
+WateringPrediction AdaptiveWatering::predict(int tentId, const Tent& tent, qint64 now) const {
+    bool live = tent.trend.samples() > 0 && now - tent.trend.lastTime() < StaleAfterMs;
+    return {tentId, live, live ? tent.trend.predictCrossing(tent.threshold) : -1};
+}
@@ -0,0 +1,80 @@
+#ifndef ADAPTIVEWATERING_H
+#define ADAPTIVEWATERING_H
+
+#include <QHash>
+#include <QVector>
+
+#include "gardendb.h"
+#include "telemetry.h"
+
+// Least-squares line through soil moisture over time, with older readings
+// fading out (half-life of a few hours) so the fit follows the current dry
+// down. Keeps only weighted running sums, so adding a reading is O(1) and
+// nothing is stored per reading. A jump up means the tent was watered: the
+// curve starts over from there.
+class MoistureTrend {
+public:
+    void add(qint64 time, double moisture);
+    void reset();
+
+    int samples() const { return n; }
+    qint64 lastTime() const { return last; }
+    double lastValue() const { return lastMoisture; }
+    // Fitted change per hour; only meaningful once canPredict()
+    double slopePerHour() const;
+    bool canPredict() const;
+    // When the fitted line reaches threshold (ms since epoch), the last
+    // reading's time if it is already below, or -1 if it isn't falling
+    qint64 predictCrossing(double threshold) const;
+
+private:
+    qint64 origin = 0;  // x is hours since origin, to keep the sums well conditioned
+    qint64 first = 0;
+    qint64 last = 0;
+    double lastMoisture = 0;
+    int n = 0;
+    double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+};
+
+struct WateringPrediction {
+    int tentId;
+    bool live;   // moisture telemetry is current
+    qint64 due;  // ms since epoch, -1 for none in sight
+};
+
+// Moisture trends for the adaptive tents, turned into predictions for
+// ScheduleQueue::setPrediction.
+class AdaptiveWatering {
+public:
+    // Tracks the adaptive tents among these; trends of tents that stay are kept
+    void setTents(const QVector<TentSchedule>& tents);
+    bool isTracked(int tentId) const { return tents.contains(tentId); }
+    bool hasTrend(int tentId) const;
+    QVector<int> trackedTents() const { return tents.keys().toVector(); }
+
+    // Warms a trend up from history (minute rollup means), e.g. at startup
+    void seed(int tentId, const QVector<Rollup>& minutes);
+
+    // Folds in a batch of readings. Returns a prediction for each adaptive
+    // tent that got a moisture reading: O(readings + tents touched).
+    QVector<WateringPrediction> update(const QVector<Reading>& batch, qint64 now);
+    // Current predictions for every adaptive tent
+    QVector<WateringPrediction> predictions(qint64 now);
+    // Tents whose last moisture reading is too old to trust any more
+    QVector<WateringPrediction> expire(qint64 now);
+
+private:
+    struct Tent {
+        double threshold = 0.35;
+        MoistureTrend trend;
+        bool live = false;
+        bool touched = false;
+    };
+
+    WateringPrediction predict(int tentId, const Tent& tent, qint64 now) const;
+
+    QHash<int, Tent> tents;  // adaptive tents only
+    QVector<int> touched;
+};
+
+#endif // ADAPTIVEWATERING_H
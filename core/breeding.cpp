@@ -0,0 +1,288 @@
+#include "breeding.h"
+
+#include <QtConcurrent>
+#include <QtMath>
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace {
+// Valid range and mutation step per trait slot; padding slots stay at zero
+const float TraitMin[PackedTraitSlots] = {
+    0.0f, 0.0f, 0.3f, 0.0f, 0.0f, 0.3f, 0.3f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.3f, 50.0f, 0.0f, 0.0f
+};
+const float TraitMax[PackedTraitSlots] = {
+    1.0f, 1.0f, 3.0f, 1.0f, 1.0f, 2.0f, 2.0f, 1.0f, 1.0f, 25.0f, 500.0f, 1.0f, 3.0f, 400.0f, 0.0f, 0.0f
+};
+
+// What a grower selects for: dense buds, vigour and clonability; against
+// hermies, foxtails, heavy feeders and cold sensitivity. Applied to traits
+// normalized to 0–1.
+const float FitnessWeight[PackedTraitSlots] = {
+    3.0f, 0.0f, 0.5f, 1.0f, 1.0f, -0.5f, -0.5f, -2.0f, -4.0f, -0.5f, 0.5f, 0.0f, 0.3f, 0.0f, 0.0f, 0.0f
+};
+
+void clampTraits(PackedGenome& g) {
+    for (int i = 0; i < PackedTraitSlots; ++i)
+        g.traits[i] = std::min(std::max(g.traits[i], TraitMin[i]), TraitMax[i]);
+}
+
+QRandomGenerator generatorFor(quint64 seed, int generation, int stream) {
+    const quint32 words[4] = { quint32(seed), quint32(seed >> 32), quint32(generation), quint32(stream) };
+    return QRandomGenerator(words, words + 4);
+}
+
+// Run fn(chunk, begin, end) over [0, n) in fixed-size chunks on the global thread pool.
+// Chunk boundaries don't depend on the thread count, which keeps runs reproducible.
+const int ChunkSize = 2048;
+
+void parallelChunks(int n, const std::function<void(int, int, int)>& fn) {
+    QVector<int> chunks;
+    for (int c = 0; c * ChunkSize < n; ++c) chunks << c;
+    QtConcurrent::blockingMap(chunks, [&](int c) {
+        fn(c, c * ChunkSize, qMin(n, (c + 1) * ChunkSize));
+    });
+}
+}
+
+PackedGenome packGenome(const PlantGenome& genome) {
+    PackedGenome p;
+    std::fill(p.traits, p.traits + PackedTraitSlots, 0.0f);
+    p.traits[TraitBudDensity] = genome.budDensity;
+    p.traits[TraitRootPriority] = genome.rootPriority;
+    p.traits[TraitTipSpeed] = genome.tipSpeed;
+    p.traits[TraitRecoveryRate] = genome.recoveryRate;
+    p.traits[TraitCloneSuccessRate] = genome.cloneSuccessRate;
+    p.traits[TraitNutrientUseRate] = genome.nutrientUseRate;
+    p.traits[TraitWaterUseRate] = genome.waterUseRate;
+    p.traits[TraitFoxTailingChance] = genome.foxTailingChance;
+    p.traits[TraitHermieChance] = genome.hermieChance;
+    p.traits[TraitColdShockThreshold] = genome.coldShockThreshold;
+    p.traits[TraitSeedYield] = genome.seedYield;
+    p.traits[TraitSativaRatio] = genome.sativaRatio;
+    p.traits[TraitPlantDensity] = genome.plantDensity;
+    p.traits[TraitMaxHeight] = genome.maxHeight;
+    p.flags = (genome.twinNode ? FlagTwinNode : 0) | (genome.triploid ? FlagTriploid : 0);
+    return p;
+}
+
+void unpackGenome(const PackedGenome& p, PlantGenome& genome) {
+    genome.budDensity = p.traits[TraitBudDensity];
+    genome.rootPriority = p.traits[TraitRootPriority];
+    genome.tipSpeed = p.traits[TraitTipSpeed];
+    genome.recoveryRate = p.traits[TraitRecoveryRate];
+    genome.cloneSuccessRate = p.traits[TraitCloneSuccessRate];
+    genome.nutrientUseRate = p.traits[TraitNutrientUseRate];
+    genome.waterUseRate = p.traits[TraitWaterUseRate];
+    genome.foxTailingChance = p.traits[TraitFoxTailingChance];
+    genome.hermieChance = p.traits[TraitHermieChance];
+    genome.coldShockThreshold = p.traits[TraitColdShockThreshold];
+    genome.seedYield = qRound(p.traits[TraitSeedYield]);
+    genome.sativaRatio = p.traits[TraitSativaRatio];
+    genome.plantDensity = p.traits[TraitPlantDensity];
+    genome.maxHeight = p.traits[TraitMaxHeight];
+    genome.twinNode = p.flags & FlagTwinNode;
+    genome.triploid = p.flags & FlagTriploid;
+}
+
+void crossover(const PackedGenome& a, const PackedGenome& b, PackedGenome& child, QRandomGenerator& rng) {
+    // Each trait comes mostly from one parent, with a 15% pull toward the other
+    quint32 bits = rng.generate();
+    float w[PackedTraitSlots];
+    for (int i = 0; i < PackedTraitSlots; ++i)
+        w[i] = ((bits >> i) & 1) ? 0.85f : 0.15f;
+    for (int i = 0; i < PackedTraitSlots; ++i)
+        child.traits[i] = a.traits[i] + w[i] * (b.traits[i] - a.traits[i]);
+
+    quint8 mask = quint8(bits >> 24);
+    child.flags = (a.flags & mask) | (b.flags & ~mask);
+    clampTraits(child);
+}
+
+void mutate(PackedGenome& genome, float rate, QRandomGenerator& rng) {
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    float delta[PackedTraitSlots];
+    for (int i = 0; i < PackedTraitSlots; ++i)
+        delta[i] = rng.generateDouble() < rate ? noise(rng) : 0.0f;
+    for (int i = 0; i < PackedTraitSlots; ++i)
+        genome.traits[i] += delta[i] * 0.05f * (TraitMax[i] - TraitMin[i]);
+    clampTraits(genome);
+
+    // Rare flips of the discrete traits
+    if (rng.generateDouble() < rate * 0.02) genome.flags ^= FlagTwinNode;
+}
+
+float fitness(const PackedGenome& genome) {
+    float score = 0.0f;
+    for (int i = 0; i < TraitCount; ++i)
+        score += FitnessWeight[i] * (genome.traits[i] - TraitMin[i]) / (TraitMax[i] - TraitMin[i]);
+    return score;
+}
+
+bool applySTS(Plant& plant, QString* why) {
+    if (!plant.isFemale) {
+        if (why) *why = "STS only reverses females";
+        return false;
+    }
+    if (plant.genome.wasSTSConverted) {
+        if (why) *why = plant.genome.strain + " is already STS converted";
+        return false;
+    }
+    plant.genome.wasSTSConverted = true;
+    return true;
+}
+
+bool clonePlant(const Plant& source, Plant& clone, QRandomGenerator& rng, QString* why) {
+    if (source.age < 14) {
+        if (why) *why = source.genome.strain + " is too young to take cuttings";
+        return false;
+    }
+    // Stressed mothers root poorly
+    double chance = source.genome.cloneSuccessRate * (0.5 + 0.5 * source.health);
+    if (rng.generateDouble() >= chance) {
+        if (why) *why = "Cutting from " + source.genome.strain + " failed to root";
+        return false;
+    }
+
+    clone = source;
+    clone.seed = rng.generate();
+    clone.genome.wasSTSConverted = false; // treatment, not genetics
+    clone.isClone = true;
+    clone.isHermie = false;
+    clone.age = 0;
+    clone.hydration = 1.0f;
+    clone.nutrients = 1.0f;
+    clone.health = 1.0f;
+    return true;
+}
+
+bool breedPlants(const Plant& mother, const Plant& donor, int maxSeeds,
+                 QVector<Plant>& seeds, QRandomGenerator& rng, QString* why) {
+    if (!mother.isFemale) {
+        if (why) *why = mother.genome.strain + " is not female";
+        return false;
+    }
+    if (mother.genome.triploid || donor.genome.triploid) {
+        if (why) *why = "Triploid plants are sterile";
+        return false;
+    }
+    // Reversed or hermie females make pollen that only carries X
+    bool feminized = donor.isFemale && (donor.genome.wasSTSConverted || donor.isHermie);
+    if (donor.isFemale && !feminized) {
+        if (why) *why = donor.genome.strain + " makes no pollen (apply STS first)";
+        return false;
+    }
+    int count = qMin(maxSeeds, mother.genome.seedYield);
+    if (count <= 0) {
+        if (why) *why = mother.genome.strain + " set no seed";
+        return false;
+    }
+
+    QString strain = mother.genome.strain == donor.genome.strain
+        ? mother.genome.strain + " S1"
+        : mother.genome.strain + " x " + donor.genome.strain;
+    PackedGenome a = packGenome(mother.genome);
+    PackedGenome b = packGenome(donor.genome);
+
+    for (int n = 0; n < count; ++n) {
+        PackedGenome c;
+        crossover(a, b, c, rng);
+        mutate(c, 0.1f, rng);
+
+        Plant seed;
+        seed.genome.strain = strain;
+        seed.genome.startColor = rng.bounded(2) ? mother.genome.startColor : donor.genome.startColor;
+        seed.genome.endColor = rng.bounded(2) ? mother.genome.endColor : donor.genome.endColor;
+        unpackGenome(c, seed.genome);
+        // Natural hermies pass the trait on; STS pollen carries much less of it
+        if (donor.isHermie && !donor.genome.wasSTSConverted)
+            seed.genome.hermieChance = qMin(1.0f, seed.genome.hermieChance * 1.5f + 0.02f);
+        else if (feminized)
+            seed.genome.hermieChance = qMin(1.0f, seed.genome.hermieChance + 0.01f);
+        seed.seed = rng.generate();
+        seed.isFemale = feminized || rng.bounded(2) == 0;
+        seeds << seed;
+    }
+    return true;
+}
+
+SelectionResult runSelection(const QVector<PackedGenome>& founders, const SelectionConfig& config,
+                             const std::function<void(const GenerationStats&)>& progress) {
+    SelectionResult result;
+    if (founders.isEmpty()) return result;
+
+    const int n = qMax(2, config.population);
+    const int elites = qBound(1, int(n * config.eliteFraction), n);
+    QVector<PackedGenome> pop(n), next(n);
+    QVector<float> scores(n);
+    QVector<int> order(n);
+
+    // Generation 0: founders with mutation around them
+    parallelChunks(n, [&](int chunk, int begin, int end) {
+        QRandomGenerator rng = generatorFor(config.seed, -1, chunk);
+        for (int i = begin; i < end; ++i) {
+            pop[i] = founders[i % founders.size()];
+            mutate(pop[i], 0.5f, rng);
+        }
+    });
+
+    for (int gen = 0; gen <= config.generations; ++gen) {
+        parallelChunks(n, [&](int, int begin, int end) {
+            for (int i = begin; i < end; ++i)
+                scores[i] = fitness(pop[i]);
+        });
+
+        // Rank, and measure how far the population has converged
+        std::iota(order.begin(), order.end(), 0);
+        std::partial_sort(order.begin(), order.begin() + elites, order.end(),
+                          [&](int x, int y) { return scores[x] > scores[y]; });
+
+        double mean[PackedTraitSlots] = {}, sq[PackedTraitSlots] = {};
+        double total = 0;
+        for (int i = 0; i < n; ++i) {
+            total += scores[i];
+            for (int t = 0; t < PackedTraitSlots; ++t) {
+                mean[t] += pop[i].traits[t];
+                sq[t] += double(pop[i].traits[t]) * pop[i].traits[t];
+            }
+        }
+        double spread = 0;
+        for (int t = 0; t < TraitCount; ++t) {
+            double m = mean[t] / n;
+            double sd = qSqrt(qMax(0.0, sq[t] / n - m * m));
+            spread += sd / (TraitMax[t] - TraitMin[t]);
+        }
+
+        GenerationStats stats;
+        stats.generation = gen;
+        stats.bestFitness = scores[order[0]];
+        stats.meanFitness = float(total / n);
+        stats.traitSpread = float(spread / TraitCount);
+        result.history << stats;
+        result.best = pop[order[0]];
+        if (progress) progress(stats);
+
+        if (gen == config.generations) break;
+
+        for (int i = 0; i < elites; ++i)
+            next[i] = pop[order[i]];
+
+        parallelChunks(n, [&](int chunk, int begin, int end) {
+            QRandomGenerator rng = generatorFor(config.seed, gen, chunk);
+            auto tournament = [&]() -> int {
+                int best = rng.bounded(n);
+                for (int k = 1; k < config.tournamentSize; ++k) {
+                    int c = rng.bounded(n);
+                    if (scores[c] > scores[best]) best = c;
+                }
+                return best;
+            };
+            for (int i = qMax(begin, elites); i < end; ++i) {
+                crossover(pop[tournament()], pop[tournament()], next[i], rng);
+                mutate(next[i], config.mutationRate, rng);
+            }
+        });
+        pop.swap(next);
+    }
+    return result;
+}
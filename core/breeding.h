@@ -0,0 +1,88 @@
+#ifndef BREEDING_H
+#define BREEDING_H
+
+#include <QVector>
+#include <QRandomGenerator>
+#include <functional>
+
+#include "plant.h"
+
+// Numeric traits of PlantGenome as one flat vector, so crossover, mutation and
+// scoring are straight loops over a fixed-size float array the compiler can
+// vectorize. The order is part of the format: append, never reorder.
+enum Trait {
+    TraitBudDensity,
+    TraitRootPriority,
+    TraitTipSpeed,
+    TraitRecoveryRate,
+    TraitCloneSuccessRate,
+    TraitNutrientUseRate,
+    TraitWaterUseRate,
+    TraitFoxTailingChance,
+    TraitHermieChance,
+    TraitColdShockThreshold,
+    TraitSeedYield,
+    TraitSativaRatio,
+    TraitPlantDensity,
+    TraitMaxHeight,
+    TraitCount
+};
+
+const int PackedTraitSlots = 16; // TraitCount padded to a whole number of SIMD lanes
+
+enum GenomeFlag : quint8 {
+    FlagTwinNode = 0x1,
+    FlagTriploid = 0x2
+};
+
+struct alignas(16) PackedGenome {
+    float traits[PackedTraitSlots];
+    quint8 flags;
+};
+
+PackedGenome packGenome(const PlantGenome& genome);
+// Writes the numeric traits and flags back; strain name and colours are left alone
+void unpackGenome(const PackedGenome& packed, PlantGenome& genome);
+
+// Uniform crossover with a little blending, then per-trait gaussian mutation, clamped to sane ranges
+void crossover(const PackedGenome& a, const PackedGenome& b, PackedGenome& child, QRandomGenerator& rng);
+void mutate(PackedGenome& genome, float rate, QRandomGenerator& rng);
+float fitness(const PackedGenome& genome);
+
+// Plant-level operations used by the toolbox buttons. They return false and
+// set `why` when the operation isn't possible for these plants.
+bool applySTS(Plant& plant, QString* why);
+bool clonePlant(const Plant& source, Plant& clone, QRandomGenerator& rng, QString* why);
+bool breedPlants(const Plant& mother, const Plant& donor, int maxSeeds,
+                 QVector<Plant>& seeds, QRandomGenerator& rng, QString* why);
+
+struct SelectionConfig {
+    int population = 20000;
+    int generations = 30;
+    float mutationRate = 0.15f;
+    float eliteFraction = 0.02f;
+    int tournamentSize = 4;
+    quint64 seed = 1;
+};
+
+struct GenerationStats {
+    int generation;
+    float bestFitness;
+    float meanFitness;
+    float traitSpread;    // mean normalized std-dev across traits; near 0 = stable strain
+};
+
+struct SelectionResult {
+    PackedGenome best;
+    QVector<GenerationStats> history;
+};
+
+// Multi-generation selection seeded from `founders`: each generation keeps its
+// best eliteFraction unchanged and breeds the rest from tournament winners.
+// Each generation is scored and bred in parallel in fixed chunks of children;
+// every chunk draws from its own generator seeded by (seed, generation,
+// chunk), so results don't depend on thread scheduling.
+SelectionResult runSelection(const QVector<PackedGenome>& founders, const SelectionConfig& config,
+                             const std::function<void(const GenerationStats&)>& progress = nullptr);
+
+#endif // BREEDING_H
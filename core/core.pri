@@ -0,0 +1,15 @@
+# Links an app against the plantercore static library. The library has to be
+# built first: build everything from planter-all.pro, or core/core.pro into
+# the matching shadow directory.
+
+QT += sql concurrent network
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+CORE_BUILD = $$shadowed($$PWD)
+win32:CONFIG(release, debug|release): CORE_BUILD = $$CORE_BUILD/release
+else:win32:CONFIG(debug, debug|release): CORE_BUILD = $$CORE_BUILD/debug
+
+LIBS += -L$$CORE_BUILD -lplantercore
+win32-msvc*: PRE_TARGETDEPS += $$CORE_BUILD/plantercore.lib
+else: PRE_TARGETDEPS += $$CORE_BUILD/libplantercore.a
@@ -0,0 +1,53 @@
+# Code shared by the PlantER apps: SunSet, the garden database, schedule,
+# telemetry and gardend protocol, and the 420Grower plant simulation. Built
+# as a static library; apps pull it in with include(../core/core.pri).
+
+QT       += core gui sql concurrent network
+QT       -= widgets
+
+TEMPLATE = lib
+CONFIG += staticlib c++11
+TARGET = plantercore
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    adaptivewatering.cpp \
+    breeding.cpp \
+    eventlog.cpp \
+    gardenclient.cpp \
+    gardendb.cpp \
+    gardenproto.cpp \
+    gardenset.cpp \
+    logbuffer.cpp \
+    minmaxpyramid.cpp \
+    plantindex.cpp \
+    schedule.cpp \
+    scheduler.cpp \
+    simulation.cpp \
+    sunset.cpp \
+    telemetry.cpp \
+    telemetrypipeline.cpp \
+    telemetrysources.cpp \
+    timeline.cpp
+
+HEADERS += \
+    adaptivewatering.h \
+    breeding.h \
+    eventlog.h \
+    gardenclient.h \
+    gardendb.h \
+    gardenproto.h \
+    gardenset.h \
+    logbuffer.h \
+    minmaxpyramid.h \
+    plant.h \
+    plantindex.h \
+    schedule.h \
+    scheduler.h \
+    simulation.h \
+    sunset.h \
+    telemetry.h \
+    telemetrypipeline.h \
+    telemetrysources.h \
+    timeline.h
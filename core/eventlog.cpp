@@ -0,0 +1,276 @@
+#include "eventlog.h"
+
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+// Alerts come a few at a time; this is room for a long stall of the disk
+const int RingCapacity = 4096;
+const int FlushIntervalMs = 200;
+// rowidOf() answers for this many of the latest committed events, far more
+// than can be committed while one events() query runs
+const int RememberedRowids = 4 * RingCapacity;
+
+// gardend and GardenDemo can both write to the garden database
+const char* BusyTimeout = "PRAGMA busy_timeout=5000";
+
+QString connectionName(const char* role, const void* owner) {
+    return QString("events-%1-%2").arg(role).arg(quintptr(owner), 0, 16);
+}
+
+void dropConnection(const QString& name) {
+    if (!QSqlDatabase::contains(name)) return;
+    QSqlDatabase::database(name, false).close();
+    QSqlDatabase::removeDatabase(name);
+}
+}
+
+QString gardenEventKindName(GardenEventKind kind) {
+    switch (kind) {
+    case GardenEventKind::Alert: return "alert";
+    case GardenEventKind::Acknowledged: return "acknowledged";
+    case GardenEventKind::Manual: return "manual";
+    }
+    return QString();
+}
+
+EventWriter::EventWriter(const QString& path, QObject* parent)
+    : QObject(parent), path(path), connection(connectionName("writer", this)),
+      ring(RingCapacity) {
+}
+
+EventWriter::~EventWriter() {
+    dropConnection(connection);
+}
+
+bool EventWriter::start(QString* error) {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(path);
+    if (!db.open()) {
+        *error = QString("%1: %2").arg(path, db.lastError().text());
+        return false;
+    }
+    QSqlQuery(db).exec(BusyTimeout);
+    timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, &EventWriter::flush);
+    timer->start(FlushIntervalMs);
+    return true;
+}
+
+void EventWriter::push(const GardenEvent& event) {
+    QMutexLocker lock(&ringMutex);
+    if (count == RingCapacity) {
+        head = (head + 1) % RingCapacity;
+        count--;
+        dropped++;
+    }
+    PendingEvent& slot = ring[(head + count) % RingCapacity];
+    slot.seq = nextSeq++;
+    slot.event = event;
+    count++;
+}
+
+QVector<PendingEvent> EventWriter::pending() const {
+    QMutexLocker lock(&ringMutex);
+    QVector<PendingEvent> out = batch;
+    for (int i = 0; i < count; ++i) out.append(ring[(head + i) % RingCapacity]);
+    return out;
+}
+
+qint64 EventWriter::rowidOf(qint64 seq) const {
+    QMutexLocker lock(&ringMutex);
+    auto it = rowids.constFind(seq);
+    if (it != rowids.constEnd()) return it.value();
+    return seq <= committedSeq ? -1 : 0;
+}
+
+qint64 EventWriter::droppedCount() const {
+    QMutexLocker lock(&ringMutex);
+    return dropped;
+}
+
+void EventWriter::flush() {
+    {
+        QMutexLocker lock(&ringMutex);
+        for (int i = 0; i < count; ++i) batch.append(ring[(head + i) % RingCapacity]);
+        head = count = 0;
+    }
+    if (batch.isEmpty()) return;
+
+    // Only this thread changes batch, so it is read here without the lock
+    const QVector<PendingEvent>& rows = batch;
+    QVector<qint64> inserted;
+    inserted.reserve(rows.size());
+    QSqlDatabase db = QSqlDatabase::database(connection, false);
+    QSqlQuery q(db);
+    bool ok = db.transaction() && q.prepare("INSERT INTO events (t, tent, kind, action, detail) VALUES (?, ?, ?, ?, ?)");
+    for (int i = 0; ok && i < rows.size(); ++i) {
+        const GardenEvent& e = rows[i].event;
+        q.bindValue(0, e.time);
+        q.bindValue(1, e.tent);
+        q.bindValue(2, int(e.kind));
+        q.bindValue(3, e.action);
+        q.bindValue(4, e.detail);
+        ok = q.exec();
+        if (ok) inserted.append(q.lastInsertId().toLongLong());
+    }
+    if (ok) {
+        QMutexLocker lock(&ringMutex);
+        for (int i = 0; i < rows.size(); ++i) rowids.insert(rows[i].seq, inserted[i]);
+    }
+    if (ok && db.commit()) {
+        QMutexLocker lock(&ringMutex);
+        committedSeq = batch.last().seq;
+        batch.clear();
+        while (!rowids.isEmpty() && rowids.firstKey() <= committedSeq - RememberedRowids)
+            rowids.erase(rowids.begin());
+        return;
+    }
+
+    QString error = q.lastError().isValid() ? q.lastError().text() : db.lastError().text();
+    db.rollback();
+    QMutexLocker lock(&ringMutex);
+    for (const PendingEvent& p : batch) rowids.remove(p.seq);
+    // Keep the batch for the next attempt, but no more than the ring would hold
+    if (batch.size() > RingCapacity) {
+        int excess = batch.size() - RingCapacity;
+        batch.remove(0, excess);
+        dropped += excess;
+    }
+    lock.unlock();
+    emit writeFailed(error);
+}
+
+EventLog::EventLog(QObject* parent) : QObject(parent), readConnection(connectionName("reader", this)) {
+    thread.setObjectName("events");
+}
+
+EventLog::~EventLog() {
+    close();
+}
+
+bool EventLog::open(const QString& path, QString* error) {
+    close();
+    QString message;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", readConnection);
+        db.setDatabaseName(path);
+        if (db.open()) {
+            QSqlQuery q(db);
+            q.exec(BusyTimeout);
+            if (!q.exec("CREATE TABLE IF NOT EXISTS events (t INT, tent INT, kind INT, action TEXT, detail TEXT)")
+                || !q.exec("CREATE INDEX IF NOT EXISTS events_by_tent ON events (tent, t)")
+                || !q.exec("CREATE INDEX IF NOT EXISTS events_by_time ON events (t)"))
+                message = q.lastError().text();
+        } else {
+            message = db.lastError().text();
+        }
+    }
+    if (!message.isEmpty()) {
+        dropConnection(readConnection);
+        if (error) *error = QString("%1: %2").arg(path, message);
+        return false;
+    }
+
+    writer = new EventWriter(path);
+    connect(writer, &EventWriter::writeFailed, this, &EventLog::writeFailed);
+    writer->moveToThread(&thread);
+    thread.start();
+    bool ok = false;
+    QMetaObject::invokeMethod(writer, [&]() { ok = writer->start(&message); }, Qt::BlockingQueuedConnection);
+    if (!ok) {
+        close();
+        if (error) *error = message;
+    }
+    return ok;
+}
+
+void EventLog::close() {
+    if (writer) {
+        // The writer's connection belongs to its thread, so it is flushed and
+        // deleted there (deleteLater: as the thread finishes)
+        QMetaObject::invokeMethod(writer, [this]() {
+            writer->flush();
+            writer->deleteLater();
+        }, Qt::BlockingQueuedConnection);
+        thread.quit();
+        thread.wait();
+        writer = nullptr;
+    }
+    dropConnection(readConnection);
+}
+
+void EventLog::record(const GardenEvent& event) {
+    if (writer) writer->push(event);
+}
+
+void EventLog::record(GardenEventKind kind, int tent, const QString& action, const QString& detail) {
+    GardenEvent e;
+    e.time = QDateTime::currentMSecsSinceEpoch();
+    e.tent = tent;
+    e.kind = kind;
+    e.action = action;
+    e.detail = detail;
+    record(e);
+}
+
+QVector<GardenEvent> EventLog::events(int tent, qint64 from, qint64 to) const {
+    QVector<GardenEvent> out;
+    if (!writer) return out;
+
+    // Whatever is waiting now; some of it may be committed while the query runs
+    const QVector<PendingEvent> waiting = writer->pending();
+
+    // One read transaction, so the rows and MAX(rowid) come from the same snapshot
+    QSqlDatabase db = QSqlDatabase::database(readConnection, false);
+    db.transaction();
+    qint64 seen = 0;
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    if (q.exec("SELECT MAX(rowid) FROM events") && q.next()) seen = q.value(0).toLongLong();
+    if (tent) {
+        q.prepare("SELECT t, tent, kind, action, detail FROM events WHERE tent = ? AND t >= ? AND t < ? ORDER BY t");
+        q.addBindValue(tent);
+    } else {
+        q.prepare("SELECT t, tent, kind, action, detail FROM events WHERE t >= ? AND t < ? ORDER BY t");
+    }
+    q.addBindValue(from);
+    q.addBindValue(to);
+    if (q.exec()) {
+        while (q.next()) {
+            GardenEvent e;
+            e.time = q.value(0).toLongLong();
+            e.tent = q.value(1).toInt();
+            e.kind = GardenEventKind(q.value(2).toInt());
+            e.action = q.value(3).toString();
+            e.detail = q.value(4).toString();
+            out.append(e);
+        }
+    }
+    q.finish();
+    db.commit();
+
+    int stored = out.size();
+    for (const PendingEvent& p : waiting) {
+        const GardenEvent& e = p.event;
+        if ((tent != 0 && e.tent != tent) || e.time < from || e.time >= to) continue;
+        // Already among the rows when it was written at or below what the query saw
+        const qint64 rowid = writer->rowidOf(p.seq);
+        if (rowid < 0 || (rowid > 0 && rowid <= seen)) continue;
+        out.append(e);
+    }
+    if (out.size() > stored) {
+        std::stable_sort(out.begin(), out.end(), [](const GardenEvent& a, const GardenEvent& b) {
+            return a.time < b.time;
+        });
+    }
+    return out;
+}
+
+qint64 EventLog::dropped() const {
+    return writer ? writer->droppedCount() : 0;
+}
@@ -0,0 +1,109 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+class QTimer;
+
+// What happened in the garden, for history: alerts as they fire, the
+// grower acknowledging them, and actions taken by hand.
+enum class GardenEventKind : quint8 { Alert = 0, Acknowledged, Manual };
+
+QString gardenEventKindName(GardenEventKind kind);
+
+struct GardenEvent {
+    qint64 time = 0;  // ms since epoch
+    int tent = 0;     // tents.id, 0 when not about a tent
+    GardenEventKind kind = GardenEventKind::Alert;
+    QString action;   // "Water", "Feed", ...
+    QString detail;   // tent name, plants affected, ...
+};
+
+// An event waiting to be written, numbered in the order it was recorded
+struct PendingEvent {
+    qint64 seq = 0;
+    GardenEvent event;
+};
+
+// Writes the events on the log's thread: they wait in a fixed ring buffer
+// and are committed in one transaction every FlushIntervalMs.
+class EventWriter : public QObject {
+    Q_OBJECT
+
+public:
+    explicit EventWriter(const QString& path, QObject* parent = nullptr);
+    ~EventWriter();
+
+    bool start(QString* error);
+    // Any thread; only takes a short lock, never waits on SQLite. When the
+    // ring is full the oldest unwritten event is dropped.
+    void push(const GardenEvent& event);
+    // Any thread: what hasn't been committed yet, oldest first
+    QVector<PendingEvent> pending() const;
+    // Any thread: the rowid event seq was inserted as, 0 while it isn't, or -1
+    // when it was committed too long ago to remember. The rowid is known
+    // before the commit, while no other writer can get a higher one, so a
+    // read that saw MAX(rowid) >= it saw the event.
+    qint64 rowidOf(qint64 seq) const;
+    void flush();
+    qint64 droppedCount() const;
+
+signals:
+    void writeFailed(const QString& error);
+
+private:
+    QString path;
+    QString connection;
+    QTimer* timer = nullptr;
+
+    // Guards everything below. Only held for copies, never across SQLite;
+    // the writer thread alone changes batch, and only with the lock held.
+    mutable QMutex ringMutex;
+    QVector<PendingEvent> ring;
+    int head = 0;   // oldest
+    int count = 0;
+    qint64 nextSeq = 1;
+    qint64 dropped = 0;
+
+    QVector<PendingEvent> batch;  // taken from the ring, not yet committed
+    qint64 committedSeq = 0;      // every event up to this one is in the table
+    QMap<qint64, qint64> rowids;  // seq -> rowid for recently written events
+};
+
+// Append-only `events` table (in the garden database, or any SQLite file)
+// with a batching writer on its own thread, so recording an event costs the
+// caller a lock and a copy: alerts are never held up by the disk.
+class EventLog : public QObject {
+    Q_OBJECT
+
+public:
+    explicit EventLog(QObject* parent = nullptr);
+    ~EventLog();
+
+    bool open(const QString& path, QString* error = nullptr);
+    // Writes what is pending and stops the thread
+    void close();
+    bool isOpen() const { return writer != nullptr; }
+
+    void record(const GardenEvent& event);
+    // Stamped with the current time
+    void record(GardenEventKind kind, int tent, const QString& action, const QString& detail = QString());
+
+    // Events in [from, to) oldest first, including ones not yet written;
+    // tent 0 for every tent
+    QVector<GardenEvent> events(int tent, qint64 from, qint64 to) const;
+    qint64 dropped() const;
+
+signals:
+    void writeFailed(const QString& error);
+
+private:
+    QThread thread;
+    EventWriter* writer = nullptr;
+    QString readConnection;
+};
+
+#endif // EVENTLOG_H
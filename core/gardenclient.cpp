@@ -0,0 +1,94 @@
+#include "gardenclient.h"
+
+GardenClient::GardenClient(QObject* parent) : QObject(parent) {
+    connect(&socket, &QLocalSocket::disconnected, this, [this]() {
+        reader = GardenFrameReader();
+        database.clear();
+        emit disconnected();
+    });
+    connect(&socket, &QLocalSocket::readyRead, this, &GardenClient::readFrames);
+}
+
+void GardenClient::connectToDaemon(const QString& name) {
+    if (socket.state() != QLocalSocket::UnconnectedState) return;
+    socket.connectToServer(name);
+}
+
+void GardenClient::disconnectFromDaemon() {
+    if (socket.state() != QLocalSocket::UnconnectedState) socket.disconnectFromServer();
+}
+
+void GardenClient::requestTents() {
+    send(GardenFrame(GardenMessage::ListTents).frame());
+}
+
+void GardenClient::requestPlants() {
+    send(GardenFrame(GardenMessage::ListPlants).frame());
+}
+
+void GardenClient::subscribe() {
+    send(GardenFrame(GardenMessage::Subscribe).frame());
+}
+
+void GardenClient::notifyChanged() {
+    send(GardenFrame(GardenMessage::Changed).frame());
+}
+
+void GardenClient::send(const QByteArray& frame) {
+    if (isConnected()) socket.write(frame);
+}
+
+void GardenClient::readFrames() {
+    reader.append(socket.readAll());
+    QByteArray payload;
+    while (reader.next(payload)) {
+        QDataStream in(payload);
+        GardenMessage type;
+        // A payload that doesn't decode is as broken as a bad frame
+        if (openGardenPayload(in, type).status() != QDataStream::Ok) {
+            socket.abort();
+            return;
+        }
+        switch (type) {
+        case GardenMessage::Hello:
+            in >> database;
+            if (in.status() == QDataStream::Ok) emit connected();
+            else database.clear();
+            break;
+        case GardenMessage::Tents: {
+            QVector<TentSchedule> tents;
+            in >> tents;
+            if (in.status() == QDataStream::Ok) emit tentsReceived(tents);
+            break;
+        }
+        case GardenMessage::Plants: {
+            QVector<PlantRow> plants;
+            in >> plants;
+            if (in.status() == QDataStream::Ok) emit plantsReceived(plants);
+            break;
+        }
+        case GardenMessage::Alert: {
+            ScheduleAlert alert;
+            in >> alert;
+            if (in.status() == QDataStream::Ok) emit alertReceived(alert);
+            break;
+        }
+        case GardenMessage::Changed:
+            emit gardenChanged();
+            break;
+        case GardenMessage::Error: {
+            QString message;
+            in >> message;
+            if (in.status() == QDataStream::Ok) emit errorReceived(message);
+            break;
+        }
+        default:
+            break;
+        }
+        if (in.status() != QDataStream::Ok) {
+            socket.abort();
+            return;
+        }
+    }
+    if (reader.failed()) socket.abort();
+}
@@ -0,0 +1,47 @@
+#ifndef GARDENCLIENT_H
+#define GARDENCLIENT_H
+
+#include <QLocalSocket>
+
+#include "gardenproto.h"
+
+// Client side of gardend's protocol (see gardenproto.h). Replies and events
+// arrive as signals; nothing blocks.
+class GardenClient : public QObject {
+    Q_OBJECT
+
+public:
+    explicit GardenClient(QObject* parent = nullptr);
+
+    void connectToDaemon(const QString& name = gardenSocketName());
+    void disconnectFromDaemon();
+    // Connected and greeted: the daemon has said which database it serves
+    bool isConnected() const { return socket.state() == QLocalSocket::ConnectedState && !database.isEmpty(); }
+    QString databasePath() const { return database; }
+
+    void requestTents();
+    void requestPlants();
+    void subscribe();
+    // Tell the daemon (and through it every other client) the database was edited
+    void notifyChanged();
+
+signals:
+    // After the daemon's Hello, so databasePath() is known
+    void connected();
+    void disconnected();
+    void tentsReceived(const QVector<TentSchedule>& tents);
+    void plantsReceived(const QVector<PlantRow>& plants);
+    void alertReceived(const ScheduleAlert& alert);
+    void gardenChanged();
+    void errorReceived(const QString& message);
+
+private:
+    void send(const QByteArray& frame);
+    void readFrames();
+
+    QLocalSocket socket;
+    GardenFrameReader reader;
+    QString database;
+};
+
+#endif // GARDENCLIENT_H
@@ -0,0 +1,133 @@
+#include "gardendb.h"
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QDebug>
+
+QString gardenDataDir() {
+    // Not AppDataLocation: that is named after each application
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/PlantER";
+    QDir().mkpath(dir);
+    return dir;
+}
+
+QString defaultGardenDbPath() {
+    return gardenDataDir() + "/garden_demo.db";
+}
+
+bool openGardenDb(const QString& path, const QString& connection) {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(path);
+    if (!db.open()) {
+        qDebug() << "DB open error:" << db.lastError();
+        return false;
+    }
+    createGardenSchema(db);
+    return true;
+}
+
+void createGardenSchema(QSqlDatabase db) {
+    QSqlQuery q(db);
+    q.exec("CREATE TABLE IF NOT EXISTS tents (id INTEGER PRIMARY KEY, name TEXT, feed2x INT, feed1 TEXT, feed2 TEXT, water_days TEXT, feed_days TEXT, sound TEXT)");
+    q.exec("CREATE TABLE IF NOT EXISTS plants (id INTEGER PRIMARY KEY, name TEXT, tent_id INT, flower_time_days INT,flower_start_date TEXT,start_date TEXT)");
+
+    // Columns added after the first release
+    QSqlRecord tentColumns = db.record("tents");
+    if (!tentColumns.contains("adaptive"))
+        q.exec("ALTER TABLE tents ADD COLUMN adaptive INT DEFAULT 0");
+    if (!tentColumns.contains("moisture_threshold"))
+        q.exec("ALTER TABLE tents ADD COLUMN moisture_threshold REAL DEFAULT 0.35");
+}
+
+QVector<TentSchedule> loadTentSchedules(QSqlDatabase db) {
+    QVector<TentSchedule> tents;
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    if (!q.exec("SELECT id, name, feed2x, feed1, feed2, water_days, feed_days, sound, adaptive, moisture_threshold FROM tents")) {
+        qDebug() << "Failed to load tents:" << q.lastError().text();
+        return tents;
+    }
+    while (q.next()) {
+        TentSchedule t;
+        t.id = q.value(0).toInt();
+        t.name = q.value(1).toString();
+        t.feed2x = q.value(2).toInt();
+        t.feed1 = q.value(3).toString();
+        t.feed2 = q.value(4).toString();
+        t.waterDays = q.value(5).toString();
+        t.feedDays = q.value(6).toString();
+        t.sound = q.value(7).toString();
+        t.adaptive = q.value(8).toInt();
+        t.moistureThreshold = q.value(9).toDouble();
+        tents.append(t);
+    }
+    return tents;
+}
+
+PlantStage plantStage(const PlantRow& row, const QDate& today) {
+    if (!row.flowering.isValid() || today < row.flowering) return PlantStage::Veg;
+    return today < row.harvest() ? PlantStage::Flowering : PlantStage::Ready;
+}
+
+namespace {
+QVector<PlantRow> plantRows(QSqlQuery& q) {
+    QVector<PlantRow> rows;
+    while (q.next()) {
+        PlantRow row;
+        row.id = q.value(0).toInt();
+        row.name = q.value(1).toString();
+        row.tentId = q.value(2).toInt();
+        row.tentName = q.value(3).toString();
+        row.started = QDate::fromString(q.value(4).toString(), "yyyy-MM-dd");
+        row.flowering = QDate::fromString(q.value(5).toString(), "yyyy-MM-dd");
+        if (!row.flowering.isValid() && row.started.isValid()) row.flowering = row.started.addDays(DefaultVegDays);
+        row.flowerDays = q.value(6).toInt();
+        rows.append(row);
+    }
+    return rows;
+}
+
+const char* PlantColumns =
+    "SELECT p.id, p.name, COALESCE(t.id, 0), t.name, p.start_date, p.flower_start_date, p.flower_time_days"
+    " FROM plants p LEFT JOIN tents t ON p.tent_id = t.id";
+}
+
+QVector<PlantRow> loadPlantRows(QSqlDatabase db) {
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    if (!q.exec(PlantColumns)) {
+        qDebug() << "Failed to load plants:" << q.lastError().text();
+        return QVector<PlantRow>();
+    }
+    return plantRows(q);
+}
+
+QVector<PlantRow> loadPlantRows(const QString& name, QSqlDatabase db) {
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    q.prepare(QString(PlantColumns) + " WHERE p.name = ?");
+    q.addBindValue(name);
+    if (!q.exec()) {
+        qDebug() << "Failed to load plant" << name << q.lastError().text();
+        return QVector<PlantRow>();
+    }
+    return plantRows(q);
+}
+
+QVector<PlantRow> loadHarvests(const QDate& from, const QDate& to, QSqlDatabase db) {
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    q.prepare(QString(PlantColumns)
+              + QString(" WHERE date(COALESCE(NULLIF(p.flower_start_date, ''), date(p.start_date, '+%1 days')),"
+                        " '+' || p.flower_time_days || ' days') BETWEEN ? AND ?").arg(DefaultVegDays));
+    q.addBindValue(from.toString("yyyy-MM-dd"));
+    q.addBindValue(to.toString("yyyy-MM-dd"));
+    if (!q.exec()) {
+        qDebug() << "Failed to load harvests:" << q.lastError().text();
+        return QVector<PlantRow>();
+    }
+    return plantRows(q);
+}
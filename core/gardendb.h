@@ -0,0 +1,64 @@
+#ifndef GARDENDB_H
+#define GARDENDB_H
+
+#include <QDate>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+// The garden database: tents with their watering/feeding schedule, and the
+// plants assigned to them. GardenDemo works on the default connection; the
+// benchmarks open their own in-memory copies under other connection names.
+
+struct TentSchedule {
+    int id = 0;
+    QString name;
+    bool feed2x = false;
+    QString feed1, feed2;         // "HH:mm"
+    QString waterDays, feedDays;  // seven '0'/'1' flags, Sunday first
+    QString sound;
+    bool adaptive = false;           // water when soil moisture is predicted to run low
+    double moistureThreshold = 0.35; // 0–1, the level that calls for water
+};
+
+struct PlantRow {
+    int id = 0;
+    QString name;
+    QString tentName;  // empty when the plant has no tent
+    int tentId = 0;
+    QDate started;     // start_date
+    QDate flowering;   // flower_start_date, or DefaultVegDays after the start
+    int flowerDays = 0;
+
+    // Invalid when the plant has no dates at all
+    QDate harvest() const { return flowering.isValid() ? flowering.addDays(flowerDays) : QDate(); }
+};
+
+// Veg time assumed for plants not yet switched to flowering
+const int DefaultVegDays = 14;
+
+enum class PlantStage : quint8 { Veg = 0, Flowering, Ready };
+
+PlantStage plantStage(const PlantRow& row, const QDate& today);
+
+// Where gardend and GardenDemo keep their databases unless told otherwise:
+// a per-user data directory both find the same way, wherever each binary is
+// built or installed. Created on first use.
+QString gardenDataDir();
+// garden_demo.db in gardenDataDir()
+QString defaultGardenDbPath();
+
+// Opens (creating if needed) the SQLite file at path and makes sure the tables exist
+bool openGardenDb(const QString& path, const QString& connection = QLatin1String(QSqlDatabase::defaultConnection));
+void createGardenSchema(QSqlDatabase db = QSqlDatabase::database());
+
+QVector<TentSchedule> loadTentSchedules(QSqlDatabase db = QSqlDatabase::database());
+// Every plant with the name of its tent, in table order
+QVector<PlantRow> loadPlantRows(QSqlDatabase db = QSqlDatabase::database());
+// Just the plants called name (GardenDemo edits plants by name)
+QVector<PlantRow> loadPlantRows(const QString& name, QSqlDatabase db = QSqlDatabase::database());
+// Plants whose harvest() falls in [from, to], worked out by SQLite so only
+// they are read
+QVector<PlantRow> loadHarvests(const QDate& from, const QDate& to, QSqlDatabase db = QSqlDatabase::database());
+
+#endif // GARDENDB_H
@@ -0,0 +1,92 @@
+#include "gardenproto.h"
+
+#include <QtEndian>
+
+QString gardenSocketName() {
+    QString user = qEnvironmentVariable("USER", qEnvironmentVariable("USERNAME"));
+    return user.isEmpty() ? QString("planter-gardend") : "planter-gardend-" + user;
+}
+
+GardenFrame::GardenFrame(GardenMessage type) : payload(4, '\0'), stream(&payload, QIODevice::WriteOnly) {
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream.device()->seek(4); // room for the length
+    stream << quint8(type);
+}
+
+QByteArray GardenFrame::frame() const {
+    QByteArray out = payload;
+    qToBigEndian<quint32>(quint32(out.size() - 4), reinterpret_cast<uchar*>(out.data()));
+    return out;
+}
+
+void GardenFrameReader::append(const QByteArray& data) {
+    // Drop consumed frames before growing, so a busy connection doesn't creep
+    if (offset > 0 && offset >= buffer.size() / 2) {
+        buffer.remove(0, offset);
+        offset = 0;
+    }
+    buffer += data;
+}
+
+bool GardenFrameReader::next(QByteArray& payload) {
+    if (bad || buffer.size() - offset < 4) return false;
+    quint32 length = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(buffer.constData() + offset));
+    if (length == 0 || length > MaxGardenFrame) {
+        bad = true;
+        return false;
+    }
+    if (quint32(buffer.size() - offset - 4) < length) return false;
+    payload = buffer.mid(offset + 4, int(length));
+    offset += 4 + int(length);
+    if (offset == buffer.size()) {
+        buffer.clear();
+        offset = 0;
+    }
+    return true;
+}
+
+QDataStream& openGardenPayload(QDataStream& in, GardenMessage& type) {
+    in.setVersion(QDataStream::Qt_5_12);
+    quint8 raw = 0;
+    in >> raw;
+    type = GardenMessage(raw);
+    return in;
+}
+
+QDataStream& operator<<(QDataStream& out, const TentSchedule& tent) {
+    return out << qint32(tent.id) << tent.name << tent.feed2x << tent.feed1 << tent.feed2
+               << tent.waterDays << tent.feedDays << tent.sound << tent.adaptive << tent.moistureThreshold;
+}
+
+QDataStream& operator>>(QDataStream& in, TentSchedule& tent) {
+    qint32 id;
+    in >> id >> tent.name >> tent.feed2x >> tent.feed1 >> tent.feed2
+       >> tent.waterDays >> tent.feedDays >> tent.sound >> tent.adaptive >> tent.moistureThreshold;
+    tent.id = id;
+    return in;
+}
+
+QDataStream& operator<<(QDataStream& out, const PlantRow& row) {
+    return out << qint32(row.id) << row.name << qint32(row.tentId) << row.tentName
+               << row.started << row.flowering << qint32(row.flowerDays);
+}
+
+QDataStream& operator>>(QDataStream& in, PlantRow& row) {
+    qint32 id, tentId, flowerDays;
+    in >> id >> row.name >> tentId >> row.tentName >> row.started >> row.flowering >> flowerDays;
+    row.id = id;
+    row.tentId = tentId;
+    row.flowerDays = flowerDays;
+    return in;
+}
+
+QDataStream& operator<<(QDataStream& out, const ScheduleAlert& alert) {
+    return out << alert.action << alert.tentName << alert.sound << alert.due << qint32(alert.tentId);
+}
+
+QDataStream& operator>>(QDataStream& in, ScheduleAlert& alert) {
+    qint32 tentId;
+    in >> alert.action >> alert.tentName >> alert.sound >> alert.due >> tentId;
+    alert.tentId = tentId;
+    return in;
+}
@@ -0,0 +1,86 @@
+#ifndef GARDENPROTO_H
+#define GARDENPROTO_H
+
+#include <QByteArray>
+#include <QDataStream>
+
+#include "gardendb.h"
+#include "schedule.h"
+
+// gardend's local socket protocol.
+//
+// Each message is a frame: a big-endian quint32 byte count, then that many
+// bytes of QDataStream (Qt_5_12) holding a quint8 GardenMessage type and its
+// fields. Replies come back in request order, so there are no request ids;
+// events for subscribers can arrive between them. The daemon opens every
+// connection with Hello and the path of the database it serves, so a client
+// can tell whether it is looking at the same garden.
+//
+//   client -> daemon            daemon -> client
+//                               Hello   QString (absolute database path)
+//   ListTents                   Tents   QVector<TentSchedule>
+//   ListPlants                  Plants  QVector<PlantRow>
+//   Subscribe / Unsubscribe     Alert   ScheduleAlert   (subscribers only)
+//   Changed (after editing      Changed                 (other subscribers)
+//     the database directly)    Error   QString
+
+enum class GardenMessage : quint8 {
+    ListTents = 1,
+    ListPlants,
+    Subscribe,
+    Unsubscribe,
+    Changed,
+    Tents = 64,
+    Plants,
+    Alert,
+    Error,
+    Hello
+};
+
+// Larger frames mean a corrupt or hostile stream; the connection is dropped
+const quint32 MaxGardenFrame = 64 * 1024 * 1024;
+
+// Per-user socket name, so two users on one machine each get their own daemon
+QString gardenSocketName();
+
+// Builds one frame: GardenFrame(GardenMessage::Tents) << tents; then frame()
+class GardenFrame {
+public:
+    explicit GardenFrame(GardenMessage type);
+    template <typename T> GardenFrame& operator<<(const T& value) {
+        stream << value;
+        return *this;
+    }
+    QByteArray frame() const;
+
+private:
+    QByteArray payload;
+    QDataStream stream;
+};
+
+// Splits a byte stream back into payloads. Feed it whatever the socket had;
+// next() hands out complete payloads, positioned after the length prefix.
+class GardenFrameReader {
+public:
+    void append(const QByteArray& data);
+    // False when more bytes are needed, or for good once failed()
+    bool next(QByteArray& payload);
+    bool failed() const { return bad; }
+
+private:
+    QByteArray buffer;
+    int offset = 0;
+    bool bad = false;
+};
+
+// A payload from GardenFrameReader as a stream positioned after the type
+QDataStream& openGardenPayload(QDataStream& in, GardenMessage& type);
+
+QDataStream& operator<<(QDataStream& out, const TentSchedule& tent);
+QDataStream& operator>>(QDataStream& in, TentSchedule& tent);
+QDataStream& operator<<(QDataStream& out, const PlantRow& row);
+QDataStream& operator>>(QDataStream& in, PlantRow& row);
+QDataStream& operator<<(QDataStream& out, const ScheduleAlert& alert);
+QDataStream& operator>>(QDataStream& in, ScheduleAlert& alert);
+
+#endif // GARDENPROTO_H
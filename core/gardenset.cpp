@@ -0,0 +1,114 @@
+#include "gardenset.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QtConcurrent>
+#include <algorithm>
+#include <iterator>
+
+namespace {
+const char* MainGardenName = "Main";
+
+bool harvestsFirst(const GardenHarvest& a, const GardenHarvest& b) {
+    return a.plant.harvest() < b.plant.harvest();
+}
+
+// One garden's harvests, soonest first, over a connection made and dropped
+// on the pool thread that reads it
+struct ScanHarvests {
+    typedef QVector<GardenHarvest> result_type;
+
+    QDate from;
+    QDate to;
+
+    QVector<GardenHarvest> operator()(const GardenFile& garden) const {
+        QVector<GardenHarvest> out;
+        const QString connection = QString("garden-scan-%1").arg(quintptr(&garden), 0, 16);
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+            db.setDatabaseName(garden.path);
+            db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+            if (db.open())
+                for (const PlantRow& plant : loadHarvests(from, to, db)) out.append({garden.name, plant});
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(connection);
+        std::stable_sort(out.begin(), out.end(), harvestsFirst);
+        return out;
+    }
+};
+
+// Reduced in garden order, so equal dates keep the main garden first
+void mergeHarvests(QVector<GardenHarvest>& all, const QVector<GardenHarvest>& garden) {
+    QVector<GardenHarvest> merged;
+    merged.reserve(all.size() + garden.size());
+    std::merge(all.begin(), all.end(), garden.begin(), garden.end(), std::back_inserter(merged), harvestsFirst);
+    all.swap(merged);
+}
+}
+
+GardenSet::GardenSet(const QString& mainPath, const QString& dir) : mainPath(mainPath), dir(dir) {
+}
+
+GardenFile GardenSet::fileFor(const QString& name) const {
+    GardenFile g;
+    g.name = name;
+    if (name == MainGardenName) {
+        g.path = mainPath;
+        // gardend's default: beside the database it serves
+        g.telemetryPath = QFileInfo(mainPath).absolutePath() + "/garden_telemetry.db";
+        g.isMain = true;
+    } else {
+        g.path = dir + "/" + name + ".db";
+        g.telemetryPath = dir + "/" + name + ".telemetry";
+    }
+    return g;
+}
+
+QVector<GardenFile> GardenSet::gardens() const {
+    QVector<GardenFile> out;
+    out.append(fileFor(MainGardenName));
+    for (const QFileInfo& file : QDir(dir).entryInfoList(QStringList() << "*.db", QDir::Files, QDir::Name))
+        out.append(fileFor(file.completeBaseName()));
+    return out;
+}
+
+GardenFile GardenSet::garden(const QString& name) const {
+    return fileFor(name);
+}
+
+bool GardenSet::create(const QString& name, QString* error) const {
+    static const QRegularExpression valid("^[\\w -]+$");
+    if (!valid.match(name).hasMatch() || name.trimmed() != name) {
+        *error = QString("\"%1\" isn't a garden name: use letters, digits, spaces, '-' and '_'").arg(name);
+        return false;
+    }
+    const GardenFile g = fileFor(name);
+    if (g.isMain || QFileInfo::exists(g.path)) {
+        *error = QString("There is already a garden called %1").arg(name);
+        return false;
+    }
+    if (!QDir().mkpath(dir)) {
+        *error = QString("Can't create %1").arg(dir);
+        return false;
+    }
+
+    const QString connection = "garden-create";
+    bool ok = openGardenDb(g.path, connection);
+    QSqlDatabase::database(connection, false).close();
+    QSqlDatabase::removeDatabase(connection);
+    if (!ok) *error = QString("Can't create %1").arg(g.path);
+    return ok;
+}
+
+QFuture<QVector<GardenHarvest>> GardenSet::harvests(const QDate& from, const QDate& to) const {
+    QVector<GardenFile> existing;
+    for (const GardenFile& g : gardens())
+        if (QFileInfo::exists(g.path)) existing.append(g);
+
+    ScanHarvests scan;
+    scan.from = from;
+    scan.to = to;
+    return QtConcurrent::mappedReduced(existing, scan, mergeHarvests, QtConcurrent::OrderedReduce);
+}
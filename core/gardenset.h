@@ -0,0 +1,48 @@
+#ifndef GARDENSET_H
+#define GARDENSET_H
+
+#include "gardendb.h"
+
+#include <QFuture>
+
+struct GardenFile {
+    QString name;
+    QString path;           // the garden database
+    QString telemetryPath;  // its sensor time series
+    bool isMain = false;
+};
+
+struct GardenHarvest {
+    QString garden;
+    PlantRow plant;
+};
+
+// Several gardens, one SQLite file each: the main garden (garden_demo.db,
+// the one gardend serves by default) and any number more as <name>.db in a
+// directory beside it. GardenDemo keeps one of them open at a time; nothing
+// here holds a connection. Questions about every garden open each file read-only on a
+// pool thread of its own, so they take about as long as the biggest garden
+// and never disturb the open one.
+class GardenSet {
+public:
+    GardenSet(const QString& mainPath, const QString& dir);
+
+    // The main garden first, then the others by name; read from the
+    // directory each time
+    QVector<GardenFile> gardens() const;
+    GardenFile garden(const QString& name) const;
+    // A new empty garden; names are letters, digits, spaces, '-' and '_'
+    bool create(const QString& name, QString* error) const;
+
+    // Plants due for harvest in [from, to] in every garden, soonest first;
+    // the scan runs on the pool, so wait on the future or watch it
+    QFuture<QVector<GardenHarvest>> harvests(const QDate& from, const QDate& to) const;
+
+private:
+    GardenFile fileFor(const QString& name) const;
+
+    QString mainPath;
+    QString dir;
+};
+
+#endif // GARDENSET_H
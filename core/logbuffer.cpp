@@ -0,0 +1,176 @@
+#include "logbuffer.h"
+
+#include <QColor>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QTextStream>
+
+namespace {
+const char* severityTag(LogSeverity severity) {
+    switch (severity) {
+    case LogSeverity::Info: return "info";
+    case LogSeverity::Warning: return "warning";
+    case LogSeverity::Error: return "error";
+    }
+    return "";
+}
+}
+
+LogBuffer::LogBuffer(int capacity) : entries(qMax(1, capacity)) {
+}
+
+void LogBuffer::append(LogSeverity severity, int plant, quint16 code, const QString& text) {
+    LogEntry& e = entries[int(end % entries.size())];
+    e.time = QDateTime::currentMSecsSinceEpoch();
+    e.severity = severity;
+    e.plant = plant;
+    e.code = code;
+    e.text = text;
+    end++;
+    if (count < entries.size()) count++;
+}
+
+void LogBuffer::append(const LogEntry& entry) {
+    entries[int(end % entries.size())] = entry;
+    end++;
+    if (count < entries.size()) count++;
+}
+
+void LogBuffer::clear() {
+    count = 0;
+}
+
+bool LogFilter::accepts(const LogEntry& entry) const {
+    return entry.severity >= minSeverity
+        && (plant < 0 || entry.plant == plant)
+        && (text.isEmpty() || entry.text.contains(text, Qt::CaseInsensitive));
+}
+
+LogModel::LogModel(const LogBuffer* buffer, QObject* parent) : QAbstractListModel(parent), buffer(buffer) {
+    shownFrom = shownEnd = scanned = buffer->firstSeq();
+}
+
+QString LogModel::codeName(quint16 code) const {
+    return codeNames.value(code, QString::number(code));
+}
+
+void LogModel::setFilter(const LogFilter& filter) {
+    beginResetModel();
+    active = filter;
+    filtering = !filter.isEmpty();
+    matches.clear();
+    matchStart = 0;
+    shownFrom = shownEnd = scanned = buffer->firstSeq();
+    endResetModel();
+    refresh();
+}
+
+void LogModel::refresh() {
+    const qint64 first = buffer->firstSeq();
+    const qint64 end = buffer->endSeq();
+
+    if (!filtering) {
+        // Rows whose entries were overwritten go from the top...
+        qint64 gone = qMin(first, shownEnd) - shownFrom;
+        if (gone > 0) {
+            beginRemoveRows(QModelIndex(), 0, int(gone) - 1);
+            shownFrom += gone;
+            endRemoveRows();
+        }
+        if (shownEnd < first) shownFrom = shownEnd = first;
+        // ...and the new ones are added at the bottom
+        if (end > shownEnd) {
+            int rows = rowCount();
+            beginInsertRows(QModelIndex(), rows, rows + int(end - shownEnd) - 1);
+            shownEnd = end;
+            endInsertRows();
+        }
+        return;
+    }
+
+    int gone = 0;
+    while (matchStart + gone < matches.size() && matches[matchStart + gone] < first) gone++;
+    if (gone > 0) {
+        beginRemoveRows(QModelIndex(), 0, gone - 1);
+        matchStart += gone;
+        endRemoveRows();
+    }
+    if (matchStart > 4096 && matchStart > matches.size() / 2) {
+        matches.remove(0, matchStart);
+        matchStart = 0;
+    }
+
+    QVector<qint64> found;
+    for (qint64 seq = qMax(scanned, first); seq < end; ++seq)
+        if (active.accepts(buffer->at(seq))) found.append(seq);
+    scanned = end;
+    if (!found.isEmpty()) {
+        int rows = rowCount();
+        beginInsertRows(QModelIndex(), rows, rows + found.size() - 1);
+        matches += found;
+        endInsertRows();
+    }
+}
+
+int LogModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+    return filtering ? matches.size() - matchStart : int(shownEnd - shownFrom);
+}
+
+qint64 LogModel::seqAt(int row) const {
+    return filtering ? matches[matchStart + row] : shownFrom + row;
+}
+
+QVariant LogModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    // The buffer may have moved on since the last refresh
+    const qint64 seq = seqAt(index.row());
+    if (seq < buffer->firstSeq()) return QVariant();
+    const LogEntry& e = buffer->at(seq);
+    switch (role) {
+    case Qt::DisplayRole:
+        return formatLine(e);
+    case Qt::ForegroundRole:
+        if (e.severity == LogSeverity::Error) return QColor(200, 30, 30);
+        if (e.severity == LogSeverity::Warning) return QColor(176, 112, 0);
+        return QVariant();
+    case Qt::ToolTipRole:
+        return QString("%1 %2").arg(severityTag(e.severity), codeName(e.code));
+    }
+    return QVariant();
+}
+
+QString LogModel::formatLine(const LogEntry& e) const {
+    QString line = QDateTime::fromMSecsSinceEpoch(e.time).toString("hh:mm:ss.zzz ");
+    if (e.severity != LogSeverity::Info) line += QString("[%1] ").arg(severityTag(e.severity));
+    if (e.plant >= 0) line += QString("#%1 ").arg(e.plant);
+    return line + e.text;
+}
+
+bool LogModel::exportTo(const QString& path, QString* error) const {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        *error = file.errorString();
+        return false;
+    }
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    out << "time\tseverity\tplant\tcode\tmessage\n";
+    for (int row = 0; row < rowCount(); ++row) {
+        const qint64 seq = seqAt(row);
+        if (seq < buffer->firstSeq()) continue;
+        const LogEntry& e = buffer->at(seq);
+        QString text = e.text;
+        text.replace('\t', ' ').replace('\n', ' ');
+        out << QDateTime::fromMSecsSinceEpoch(e.time).toString(Qt::ISODateWithMs) << '\t'
+            << severityTag(e.severity) << '\t'
+            << (e.plant >= 0 ? QString::number(e.plant) : QString()) << '\t'
+            << codeName(e.code) << '\t' << text << '\n';
+    }
+    out.flush();
+    if (!file.commit()) {
+        *error = file.errorString();
+        return false;
+    }
+    return true;
+}
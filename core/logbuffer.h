@@ -0,0 +1,98 @@
+#ifndef LOGBUFFER_H
+#define LOGBUFFER_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QVector>
+
+enum class LogSeverity : quint8 { Info = 0, Warning, Error };
+
+struct LogEntry {
+    qint64 time = 0;  // ms since epoch
+    LogSeverity severity = LogSeverity::Info;
+    int plant = -1;   // index in the garden, -1 when not about one plant
+    quint16 code = 0; // what kind of message; names come from the app
+    QString text;
+};
+
+// The last `capacity` log entries in a ring. Every entry gets a sequence
+// number, so a reader can tell what is new and what has been evicted since it
+// last looked without the buffer tracking its readers. Appending is O(1) and
+// memory never grows past the capacity. Not thread safe.
+class LogBuffer {
+public:
+    explicit LogBuffer(int capacity = 100000);
+
+    // Stamped with the current time
+    void append(LogSeverity severity, int plant, quint16 code, const QString& text);
+    void append(const LogEntry& entry);
+    // Forgets every entry; sequence numbers carry on
+    void clear();
+
+    int capacity() const { return entries.size(); }
+    int size() const { return count; }
+    qint64 firstSeq() const { return end - count; }
+    qint64 endSeq() const { return end; }
+    // firstSeq() <= seq < endSeq()
+    const LogEntry& at(qint64 seq) const { return entries[int(seq % entries.size())]; }
+
+private:
+    QVector<LogEntry> entries;
+    qint64 end = 0;
+    int count = 0;
+};
+
+struct LogFilter {
+    LogSeverity minSeverity = LogSeverity::Info;
+    int plant = -1;  // -1 for any
+    QString text;    // case-insensitive substring, empty for any
+
+    bool isEmpty() const { return minSeverity == LogSeverity::Info && plant < 0 && text.isEmpty(); }
+    bool accepts(const LogEntry& entry) const;
+};
+
+// A LogBuffer as a list for QListView. Rows are formatted only when the view
+// asks for them, so only the visible ones cost anything. The model doesn't
+// follow each append: refresh() catches up with the buffer in one removal
+// (evicted rows) and one insertion (new rows), so the owner decides how often
+// the view repaints.
+class LogModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit LogModel(const LogBuffer* buffer, QObject* parent = nullptr);
+
+    void setCodeNames(const QStringList& names) { codeNames = names; }
+    QString codeName(quint16 code) const;
+
+    // Rescans the buffer for the new filter
+    void setFilter(const LogFilter& filter);
+    const LogFilter& filter() const { return active; }
+    void refresh();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    const LogEntry& entry(int row) const { return buffer->at(seqAt(row)); }
+    QString formatLine(const LogEntry& entry) const;
+
+    // The rows shown now, tab separated with a header line
+    bool exportTo(const QString& path, QString* error) const;
+
+private:
+    qint64 seqAt(int row) const;
+
+    const LogBuffer* buffer;
+    QStringList codeNames;
+    LogFilter active;
+    bool filtering = false;
+    // Unfiltered, the rows are the sequence numbers [shownFrom, shownEnd)
+    qint64 shownFrom = 0;
+    qint64 shownEnd = 0;
+    // Filtered, they are matches from matchStart on; the buffer has been
+    // scanned up to `scanned`
+    QVector<qint64> matches;
+    int matchStart = 0;
+    qint64 scanned = 0;
+};
+
+#endif // LOGBUFFER_H
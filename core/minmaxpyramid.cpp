@@ -0,0 +1,81 @@
+#include "minmaxpyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+void merge(MinMaxBucket& into, const MinMaxBucket& b) {
+    if (into.isEmpty()) {
+        into = b;
+        return;
+    }
+    into.first = qMin(into.first, b.first);
+    into.last = qMax(into.last, b.last);
+    into.lo = qMin(into.lo, b.lo);
+    into.hi = qMax(into.hi, b.hi);
+}
+
+const MinMaxBucket Empty = {0, -1, 0, 0};
+}
+
+MinMaxPyramid::MinMaxPyramid(int fanout) : fanout(qMax(2, fanout)) {
+    clear();
+}
+
+void MinMaxPyramid::clear() {
+    levels.clear();
+    levels.append(QVector<MinMaxBucket>());
+}
+
+bool MinMaxPyramid::append(qint64 time, float lo, float hi) {
+    if (std::isnan(lo) || std::isnan(hi)) return false;
+    if (!isEmpty() && time < lastTime()) return false;
+    const MinMaxBucket point = {time, time, qMin(lo, hi), qMax(lo, hi)};
+    levels[0].append(point);
+
+    // The new point lands in the last bucket of every level; a level is
+    // added on top once the one below has more than one bucket
+    int index = levels[0].size() - 1;
+    for (int l = 1; levels[l - 1].size() > 1; ++l) {
+        index /= fanout;
+        if (l == levels.size()) {
+            const QVector<MinMaxBucket>& below = levels[l - 1];
+            QVector<MinMaxBucket> level((below.size() + fanout - 1) / fanout, Empty);
+            for (int i = 0; i < below.size(); ++i) merge(level[i / fanout], below[i]);
+            levels.append(level);
+            continue;
+        }
+        QVector<MinMaxBucket>& level = levels[l];
+        if (index == level.size())
+            level.append(point);
+        else
+            merge(level[index], point);
+    }
+    return true;
+}
+
+QVector<MinMaxBucket> MinMaxPyramid::columns(qint64 from, qint64 to, int count) const {
+    QVector<MinMaxBucket> out(qMax(0, count), Empty);
+    if (count <= 0 || to <= from || isEmpty()) return out;
+
+    auto endsBefore = [](const MinMaxBucket& b, qint64 t) { return b.last < t; };
+    auto startsBefore = [](qint64 t, const MinMaxBucket& b) { return t < b.first; };
+
+    // The coarsest level that still gives two buckets per column
+    const QVector<MinMaxBucket>& points = levels.first();
+    qint64 inView = std::upper_bound(points.begin(), points.end(), to - 1, startsBefore)
+                  - std::lower_bound(points.begin(), points.end(), from, endsBefore);
+    int l = 0;
+    for (qint64 per = fanout; l + 1 < levels.size() && inView / per >= 2 * count; per *= fanout) ++l;
+
+    const QVector<MinMaxBucket>& level = levels[l];
+    const double scale = double(count) / double(to - from);
+    for (auto it = std::lower_bound(level.begin(), level.end(), from, endsBefore);
+         it != level.end() && it->first < to; ++it) {
+        // A bucket straddling a column edge goes where most of it lies
+        qint64 mid = it->first + (it->last - it->first) / 2;
+        int column = qBound(0, int(double(mid - from) * scale), count - 1);
+        merge(out[column], *it);
+    }
+    return out;
+}
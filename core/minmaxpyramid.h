@@ -0,0 +1,45 @@
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <QVector>
+
+struct MinMaxBucket {
+    qint64 first;  // time of the earliest point, ms since epoch
+    qint64 last;   // time of the latest; first > last marks an empty bucket
+    float lo;
+    float hi;
+
+    bool isEmpty() const { return first > last; }
+};
+
+// A time series kept at every zoom level at once, for charts. Level 0 holds
+// the points; each level above merges fanout buckets of the one below into
+// their min and max, so a year of minutes is about 8 levels at the default
+// fanout and any view is drawn from the level with a couple of buckets per
+// pixel: O(pixels) whatever the range. Appending updates one bucket per
+// level, O(log n), and the whole pyramid is under 1.2x the points.
+class MinMaxPyramid {
+public:
+    explicit MinMaxPyramid(int fanout = 8);
+
+    void clear();
+    // Points must come in time order; older ones and NaNs are refused
+    bool append(qint64 time, float value) { return append(time, value, value); }
+    // A point that already covers a range, such as a rollup's min and max
+    bool append(qint64 time, float lo, float hi);
+
+    int size() const { return levels.first().size(); }
+    bool isEmpty() const { return levels.first().isEmpty(); }
+    qint64 firstTime() const { return isEmpty() ? 0 : levels.first().first().first; }
+    qint64 lastTime() const { return isEmpty() ? 0 : levels.first().last().last; }
+
+    // Min and max over count equal slices of [from, to); slices without
+    // points come back empty
+    QVector<MinMaxBucket> columns(qint64 from, qint64 to, int count) const;
+
+private:
+    int fanout;
+    QVector<QVector<MinMaxBucket>> levels;  // levels[0] are the points
+};
+
+#endif // MINMAXPYRAMID_H
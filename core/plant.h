@@ -0,0 +1,49 @@
+#ifndef PLANT_H
+#define PLANT_H
+
+#include <QString>
+#include <QColor>
+
+// Enhanced genome structure
+struct PlantGenome {
+    QString strain = "Unnamed";
+    QColor startColor = Qt::green;
+    QColor endColor = Qt::darkGreen;
+
+    float budDensity = 0.8f; // 0–1
+    float rootPriority = 0.5f; // 0=root, 1=canopy
+    float tipSpeed = 1.0f;     // tip growth multiplier
+    float recoveryRate = 0.75f;
+
+    float cloneSuccessRate = 0.85f;
+    float nutrientUseRate = 1.0f;
+    float waterUseRate = 1.0f;
+
+    float foxTailingChance = 0.05f;
+    float hermieChance = 0.03f;
+    float coldShockThreshold = 12.0f;
+
+    int seedYield = 50;
+    float sativaRatio = 0.5f; // 0 = indica, 1 = sativa
+
+    float plantDensity = 1.0f; // 1 = default spacing, >1 = more branches
+    float maxHeight = 300.0f;  // max height for full maturity
+
+    bool twinNode = false;
+    bool triploid = false;
+    bool wasSTSConverted = false;
+};
+
+struct Plant {
+    PlantGenome genome;
+    quint32 seed = 0;       // drives branch layout, so a plant looks the same every frame
+    int age = 0;
+    float hydration = 1.0f; // 0–1
+    float nutrients = 1.0f;
+    float health = 1.0f;    // 0–1
+    bool isClone = false;
+    bool isFemale = true;
+    bool isHermie = false;
+};
+
+#endif // PLANT_H
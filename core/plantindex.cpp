@@ -0,0 +1,186 @@
+#include "plantindex.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+// Rebuild once this share of the slots is dead; below it the dead slots only
+// cost a skipped entry in a posting list
+const int CompactDivisor = 3;
+const int CompactMinimum = 64;
+
+void addPosting(QVector<int>& postings, int slot) {
+    if (postings.isEmpty() || postings.last() != slot) postings.append(slot);
+}
+
+QVector<int> intersect(const QVector<int>& a, const QVector<int>& b) {
+    QVector<int> out;
+    out.reserve(qMin(a.size(), b.size()));
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+    return out;
+}
+
+// Letters and digits make up a word; anything else separates them
+template <typename F>
+void forEachWord(const QString& text, F f) {
+    int start = -1;
+    for (int i = 0; i <= text.size(); ++i) {
+        bool inWord = i < text.size() && text[i].isLetterOrNumber();
+        if (inWord && start < 0) start = i;
+        if (!inWord && start >= 0) {
+            f(text.mid(start, i - start));
+            start = -1;
+        }
+    }
+}
+}
+
+void PlantIndex::clear() {
+    docs.clear();
+    slotOf.clear();
+    byName.clear();
+    trigrams.clear();
+    words.clear();
+    live = 0;
+}
+
+void PlantIndex::reset(const QVector<PlantRow>& rows) {
+    clear();
+    docs.reserve(rows.size());
+    slotOf.reserve(rows.size());
+    for (const PlantRow& row : rows) insert(row);
+}
+
+void PlantIndex::insert(const PlantRow& row) {
+    remove(row.id);
+    add(row);
+    live++;
+}
+
+void PlantIndex::add(const PlantRow& row) {
+    const int slot = docs.size();
+    Doc doc;
+    doc.row = row;
+    doc.text = fold(row.name + '\n' + row.tentName);
+    doc.alive = true;
+    docs.append(doc);
+    slotOf.insert(row.id, slot);
+    byName.insert(row.name, row.id);
+
+    const QString& text = docs.last().text;
+    for (int i = 0; i + 3 <= text.size(); ++i) addPosting(trigrams[trigramKey(text.constData() + i)], slot);
+    forEachWord(text, [&](const QString& word) { addPosting(words[word], slot); });
+}
+
+void PlantIndex::remove(int plantId) {
+    auto it = slotOf.find(plantId);
+    if (it == slotOf.end()) return;
+    Doc& doc = docs[it.value()];
+    doc.alive = false;
+    byName.remove(doc.row.name, plantId);
+    slotOf.erase(it);
+    live--;
+
+    const int dead = docs.size() - live;
+    if (dead >= CompactMinimum && dead * CompactDivisor > docs.size()) {
+        QVector<PlantRow> rows;
+        rows.reserve(live);
+        for (const Doc& d : docs)
+            if (d.alive) rows.append(d.row);
+        reset(rows);
+    }
+}
+
+// Slots that may hold the word: exactly for short words (by word prefix) and
+// words of three characters, a superset for longer ones
+bool PlantIndex::candidates(const QString& word, QVector<int>* out) const {
+    out->clear();
+    if (word.size() < 3) {
+        QVector<const QVector<int>*> lists;
+        int total = 0;
+        for (auto it = words.lowerBound(word); it != words.end() && it.key().startsWith(word); ++it) {
+            lists.append(&it.value());
+            total += it.value().size();
+        }
+        if (lists.isEmpty()) return false;
+        if (lists.size() == 1) {
+            *out = *lists.first();
+            return true;
+        }
+        out->reserve(total);
+        for (const QVector<int>* list : lists) *out += *list;
+        std::sort(out->begin(), out->end());
+        out->erase(std::unique(out->begin(), out->end()), out->end());
+        return true;
+    }
+
+    QVector<const QVector<int>*> lists;
+    for (int i = 0; i + 3 <= word.size(); ++i) {
+        auto it = trigrams.constFind(trigramKey(word.constData() + i));
+        if (it == trigrams.constEnd()) return false;
+        lists.append(&it.value());
+    }
+    std::sort(lists.begin(), lists.end(), [](const QVector<int>* a, const QVector<int>* b) {
+        return a->size() < b->size();
+    });
+    *out = *lists.first();
+    for (int i = 1; i < lists.size() && !out->isEmpty(); ++i) *out = intersect(*out, *lists[i]);
+    return !out->isEmpty();
+}
+
+bool PlantIndex::accepts(const Doc& doc, const PlantQuery& query, const QStringList& verify) const {
+    if (!doc.alive) return false;
+    const PlantRow& row = doc.row;
+    if (query.tentId >= 0 && row.tentId != query.tentId) return false;
+    if (query.stage >= 0 && int(plantStage(row, query.today)) != query.stage) return false;
+    if (query.harvestWithin >= 0) {
+        // Plants already past their harvest date are due too
+        if (!row.flowering.isValid() || query.today.daysTo(row.harvest()) > query.harvestWithin) return false;
+    }
+    for (const QString& word : verify)
+        if (!doc.text.contains(word)) return false;
+    return true;
+}
+
+QVector<PlantRow> PlantIndex::search(const PlantQuery& query, int limit, int* total) const {
+    PlantQuery q = query;
+    if (!q.today.isValid()) q.today = QDate::currentDate();
+
+    QVector<PlantRow> out;
+    QStringList verify;  // words longer than a trigram, which the postings only narrow down
+    int matched = 0;
+    auto visit = [&](int slot) {
+        const Doc& doc = docs[slot];
+        if (!accepts(doc, q, verify)) return;
+        if (matched++ < limit) out.append(doc.row);
+    };
+
+    // Split the query the way the index splits names, so "#3" looks for "3"
+    QStringList queryWords;
+    forEachWord(fold(q.text), [&](const QString& word) { queryWords.append(word); });
+
+    QVector<QVector<int>> lists;
+    for (const QString& word : queryWords) {
+        QVector<int> slots;
+        if (!candidates(word, &slots)) {
+            if (total) *total = 0;
+            return out;
+        }
+        if (word.size() > 3) verify.append(word);
+        lists.append(slots);
+    }
+
+    if (lists.isEmpty()) {
+        for (int slot = 0; slot < docs.size(); ++slot) visit(slot);
+    } else {
+        // Rarest word first: its candidates bound all the others
+        std::sort(lists.begin(), lists.end(), [](const QVector<int>& a, const QVector<int>& b) {
+            return a.size() < b.size();
+        });
+        QVector<int> slots = lists.first();
+        for (int i = 1; i < lists.size() && !slots.isEmpty(); ++i) slots = intersect(slots, lists[i]);
+        for (int slot : slots) visit(slot);
+    }
+    if (total) *total = matched;
+    return out;
+}
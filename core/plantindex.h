@@ -0,0 +1,67 @@
+#ifndef PLANTINDEX_H
+#define PLANTINDEX_H
+
+#include "gardendb.h"
+
+#include <QHash>
+#include <QMap>
+#include <QMultiHash>
+
+struct PlantQuery {
+    QString text;            // words that must all appear in the name or tent name
+    int tentId = -1;         // -1 for any tent, 0 for plants without one
+    int stage = -1;          // a PlantStage, -1 for any
+    int harvestWithin = -1;  // days until harvest, -1 for any
+    QDate today;             // for stage and harvestWithin; defaults to the current date
+
+    bool isEmpty() const { return text.trimmed().isEmpty() && tentId < 0 && stage < 0 && harvestWithin < 0; }
+};
+
+// Plants in memory, searchable as you type. Each plant's name and tent name
+// are indexed by trigram, which finds any substring of three or more
+// characters, and by word, which finds shorter prefixes ("g" for "Gelato").
+// Posting lists hold slots in insertion order, so they stay sorted and are
+// intersected by merging, starting with the shortest. Edits are incremental:
+// a removed plant leaves a dead slot until a third of the slots are dead and
+// the index is rebuilt. Not thread safe.
+class PlantIndex {
+public:
+    void reset(const QVector<PlantRow>& rows);
+    void insert(const PlantRow& row);
+    void remove(int plantId);
+    void clear();
+
+    int size() const { return live; }
+    bool contains(int plantId) const { return slotOf.contains(plantId); }
+    const PlantRow& plant(int plantId) const { return docs[slotOf.value(plantId)].row; }
+    QVector<int> idsNamed(const QString& name) const { return byName.values(name).toVector(); }
+
+    // The first `limit` matches in index order; *total gets the number of all
+    // matches
+    QVector<PlantRow> search(const PlantQuery& query, int limit, int* total = nullptr) const;
+
+private:
+    struct Doc {
+        PlantRow row;
+        QString text;  // folded "name\ntent", what the query words are checked against
+        bool alive = false;
+    };
+
+    static quint64 trigramKey(const QChar* c) {
+        return quint64(c[0].unicode()) << 32 | quint64(c[1].unicode()) << 16 | c[2].unicode();
+    }
+    static QString fold(const QString& text) { return text.toCaseFolded(); }
+
+    void add(const PlantRow& row);
+    bool candidates(const QString& word, QVector<int>* out) const;
+    bool accepts(const Doc& doc, const PlantQuery& query, const QStringList& verify) const;
+
+    QVector<Doc> docs;
+    QHash<int, int> slotOf;              // plant id -> slot
+    QMultiHash<QString, int> byName;     // plant name -> plant ids
+    QHash<quint64, QVector<int>> trigrams;
+    QMap<QString, QVector<int>> words;   // sorted, so a prefix is a range
+    int live = 0;
+};
+
+#endif // PLANTINDEX_H
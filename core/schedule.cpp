@@ -0,0 +1,154 @@
+#include "schedule.h"
+
+#include <algorithm>
+
+namespace {
+void appendAlerts(QVector<ScheduleAlert>& alerts, const TentSchedule& tent, int slot, const QDateTime& due,
+                  bool predictedWater = false) {
+    const int dow = due.date().dayOfWeek() % 7; // 0=Sun
+    bool water = tent.waterDays.value(dow) == '1';
+    bool feed = tent.feedDays.value(dow) == '1';
+    if (slot == 0) {
+        if (water && !predictedWater) alerts.append({"Water", tent.name, tent.sound, due, tent.id});
+        if (feed) alerts.append({"Feed", tent.name, tent.sound, due, tent.id});
+    } else if (tent.feed2x && (feed || water)) {
+        alerts.append({"Feed (2x)", tent.name, tent.sound, due, tent.id});
+    }
+}
+
+// Next time strictly after `after` that slot fires for tent, or an invalid QDateTime
+QDateTime nextOccurrence(const TentSchedule& tent, int slot, const QDateTime& after) {
+    if (slot == 1 && !tent.feed2x) return QDateTime();
+    QTime at = QTime::fromString(slot == 0 ? tent.feed1 : tent.feed2, "HH:mm");
+    if (!at.isValid()) return QDateTime();
+    // Today may already be past, so look up to the same weekday next week
+    for (int d = 0; d <= 7; ++d) {
+        QDate date = after.date().addDays(d);
+        int dow = date.dayOfWeek() % 7;
+        if (tent.waterDays.value(dow) != '1' && tent.feedDays.value(dow) != '1') continue;
+        QDateTime due(date, at);
+        if (due > after) return due;
+    }
+    return QDateTime();
+}
+
+// A tent that stays dry is reminded again after this long, not on every reading
+const qint64 RepeatAfterMs = 4 * 3600 * 1000;
+
+qint64 minuteOf(qint64 ms) {
+    return ms - ms % 60000;
+}
+}
+
+QVector<ScheduleAlert> dueAlerts(const QVector<TentSchedule>& tents, const QDateTime& now) {
+    QVector<ScheduleAlert> alerts;
+    const QDateTime minuteStart(now.date(), QTime(now.time().hour(), now.time().minute()));
+    const QString minute = now.time().toString("HH:mm");
+
+    for (const TentSchedule& tent : tents) {
+        if (tent.feed1 == minute) appendAlerts(alerts, tent, 0, minuteStart);
+        if (tent.feed2 == minute) appendAlerts(alerts, tent, 1, minuteStart);
+    }
+    return alerts;
+}
+
+bool ScheduleQueue::Later::operator()(const Entry& a, const Entry& b) const {
+    if (a.due != b.due) return a.due > b.due;
+    if (a.tent != b.tent) return a.tent > b.tent;
+    return a.slot > b.slot;
+}
+
+void ScheduleQueue::reset(const QVector<TentSchedule>& schedules, const QDateTime& from) {
+    QHash<int, Prediction> kept;
+    for (int i = 0; i < tents.size(); ++i) {
+        if (tents[i].adaptive) kept.insert(tents[i].id, predictions[i]);
+    }
+
+    tents = schedules;
+    indexOfId.clear();
+    predictions.fill(Prediction(), tents.size());
+    heap.clear();
+    heap.reserve(size_t(tents.size()) * 3);
+    stale = 0;
+    for (int i = 0; i < tents.size(); ++i) {
+        indexOfId.insert(tents[i].id, i);
+        push(i, FirstTime, from);
+        push(i, SecondTime, from);
+        if (!tents[i].adaptive) continue;
+        Prediction p = kept.value(tents[i].id);
+        predictions[i].lastFired = p.lastFired;
+        setPrediction(tents[i].id, p.live, p.due);
+    }
+}
+
+QDateTime ScheduleQueue::nextDue() const {
+    return heap.empty() ? QDateTime() : QDateTime::fromMSecsSinceEpoch(heap.front().due);
+}
+
+QVector<ScheduleAlert> ScheduleQueue::takeDue(const QDateTime& now) {
+    QVector<ScheduleAlert> alerts;
+    const qint64 limit = now.toMSecsSinceEpoch();
+    while (!heap.empty() && heap.front().due <= limit) {
+        std::pop_heap(heap.begin(), heap.end(), Later());
+        Entry e = heap.back();
+        heap.pop_back();
+        const TentSchedule& tent = tents[e.tent];
+        Prediction& p = predictions[e.tent];
+        QDateTime due = QDateTime::fromMSecsSinceEpoch(e.due);
+
+        if (e.slot == Predicted) {
+            if (e.generation != p.generation) {
+                stale--;
+                continue;
+            }
+            alerts.append({"Water (moisture)", tent.name, tent.sound, due, tent.id});
+            p.lastFired = e.due;
+            p.due = -1;
+            continue;
+        }
+        // A tent with live telemetry is watered by prediction, not by the calendar
+        appendAlerts(alerts, tent, e.slot, due, tent.adaptive && p.live);
+        push(e.tent, e.slot, due);
+    }
+    return alerts;
+}
+
+void ScheduleQueue::setPrediction(int tentId, bool live, qint64 due) {
+    auto it = indexOfId.constFind(tentId);
+    if (it == indexOfId.constEnd() || !tents[*it].adaptive) return;
+    const int tent = *it;
+    Prediction& p = predictions[tent];
+    p.live = live;
+
+    if (!live) due = -1;
+    if (due >= 0) {
+        if (p.lastFired >= 0) due = qMax(due, p.lastFired + RepeatAfterMs);
+        due = minuteOf(due);
+    }
+    if (due == p.due) return;
+
+    if (p.due >= 0) stale++; // the entry already queued for this tent no longer counts
+    p.due = due;
+    p.generation++;
+    if (due >= 0) {
+        heap.push_back({due, tent, Predicted, p.generation});
+        std::push_heap(heap.begin(), heap.end(), Later());
+    }
+    if (stale > int(heap.size()) / 2 + 16) compact();
+}
+
+void ScheduleQueue::push(int tent, int slot, const QDateTime& after) {
+    QDateTime due = nextOccurrence(tents[tent], slot, after);
+    if (!due.isValid()) return;
+    heap.push_back({due.toMSecsSinceEpoch(), tent, slot, 0});
+    std::push_heap(heap.begin(), heap.end(), Later());
+}
+
+// Drops superseded prediction entries once they outnumber the live ones
+void ScheduleQueue::compact() {
+    heap.erase(std::remove_if(heap.begin(), heap.end(), [this](const Entry& e) {
+        return e.slot == Predicted && e.generation != predictions[e.tent].generation;
+    }), heap.end());
+    std::make_heap(heap.begin(), heap.end(), Later());
+    stale = 0;
+}
@@ -0,0 +1,79 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <vector>
+
+#include "gardendb.h"
+
+struct ScheduleAlert {
+    QString action;  // "Water", "Feed", "Feed (2x)" or "Water (moisture)"
+    QString tentName;
+    QString sound;
+    QDateTime due;   // the scheduled minute
+    int tentId = 0;
+};
+
+// The alerts due in the minute of now. Water and Feed fire at the first feed
+// time on their checked days; a tent set to feed twice a day also fires
+// "Feed (2x)" at the second time on any day it is watered or fed.
+QVector<ScheduleAlert> dueAlerts(const QVector<TentSchedule>& tents, const QDateTime& now);
+
+// The same rules as dueAlerts, as a queue ordered by due time: each tent has
+// at most two entries (first and second feed time) holding its next
+// occurrence, so finding the next alert is O(1) and firing one is O(log n)
+// instead of scanning every tent each minute.
+//
+// Adaptive tents can also be watered by prediction from their soil moisture
+// trend. While a tent's telemetry is live the prediction replaces its fixed
+// Water alert; without telemetry its water days apply as usual.
+class ScheduleQueue {
+public:
+    // Queues the first occurrence of each tent's times strictly after from.
+    // Predictions for tents that are still there and still adaptive are kept.
+    void reset(const QVector<TentSchedule>& tents, const QDateTime& from);
+
+    bool isEmpty() const { return heap.empty(); }
+    int size() const { return int(heap.size()); }
+    QDateTime nextDue() const;
+
+    // Pops every entry due at or before now and requeues it for its next day
+    QVector<ScheduleAlert> takeDue(const QDateTime& now);
+
+    // Prediction for an adaptive tent: live says its moisture telemetry is
+    // current, due is the predicted watering time in ms since epoch or -1 if
+    // none is in sight. Repeats within the same minute are free; after one
+    // fires, the next waits at least four hours.
+    void setPrediction(int tentId, bool live, qint64 due);
+
+private:
+    enum Slot { FirstTime, SecondTime, Predicted };
+
+    struct Entry {
+        qint64 due;  // ms since epoch
+        int tent;
+        int slot;
+        quint32 generation;  // Predicted entries: stale once the tent's prediction moves
+    };
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const;
+    };
+    struct Prediction {
+        bool live = false;
+        qint64 due = -1;
+        qint64 lastFired = -1;
+        quint32 generation = 0;
+    };
+
+    void push(int tent, int slot, const QDateTime& after);
+    void compact();
+
+    QVector<TentSchedule> tents;
+    QHash<int, int> indexOfId;
+    QVector<Prediction> predictions;
+    std::vector<Entry> heap;
+    int stale = 0;
+};
+
+#endif // SCHEDULE_H
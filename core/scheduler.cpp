@@ -0,0 +1,54 @@
+#include "scheduler.h"
+
+namespace {
+// Wake at least this often, so clock changes and suspend/resume are noticed
+const int MaxSleepMs = 60000;
+// Alerts missed by more than this (the machine was asleep) are dropped, not replayed
+const int StaleSeconds = 600;
+}
+
+Scheduler::Scheduler(QObject* parent) : QObject(parent) {
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &Scheduler::fire);
+}
+
+void Scheduler::setTents(const QVector<TentSchedule>& tents) {
+    queue.reset(tents, QDateTime::currentDateTime());
+    arm();
+}
+
+void Scheduler::setPredictions(const QVector<WateringPrediction>& predictions) {
+    if (predictions.isEmpty()) return;
+    for (const WateringPrediction& p : predictions)
+        queue.setPrediction(p.tentId, p.live, p.due);
+    arm();
+}
+
+void Scheduler::start() {
+    running = true;
+    arm();
+}
+
+void Scheduler::stop() {
+    running = false;
+    timer.stop();
+}
+
+void Scheduler::fire() {
+    QDateTime now = QDateTime::currentDateTime();
+    for (const ScheduleAlert& alert : queue.takeDue(now)) {
+        if (alert.due.secsTo(now) < StaleSeconds)
+            emit alertDue(alert);
+    }
+    arm();
+}
+
+void Scheduler::arm() {
+    if (!running || queue.isEmpty()) {
+        timer.stop();
+        return;
+    }
+    qint64 wait = QDateTime::currentDateTime().msecsTo(queue.nextDue());
+    timer.start(int(qBound<qint64>(0, wait, MaxSleepMs)));
+}
@@ -0,0 +1,40 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+
+#include "adaptivewatering.h"
+#include "schedule.h"
+
+// Runs a ScheduleQueue against the wall clock: sleeps until the next entry is
+// due instead of polling, and emits each alert as it fires. Used by gardend
+// and by GardenDemo when no daemon is running.
+class Scheduler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit Scheduler(QObject* parent = nullptr);
+
+    // Replaces the schedule; only times after now will fire
+    void setTents(const QVector<TentSchedule>& tents);
+    // Moves adaptive tents' predicted waterings (see AdaptiveWatering)
+    void setPredictions(const QVector<WateringPrediction>& predictions);
+    void start();
+    void stop();
+    bool isRunning() const { return running; }
+    QDateTime nextDue() const { return queue.nextDue(); }
+
+signals:
+    void alertDue(const ScheduleAlert& alert);
+
+private:
+    void fire();
+    void arm();
+
+    ScheduleQueue queue;
+    QTimer timer;
+    bool running = false;
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,46 @@
+#include "simulation.h"
+
+#include <QtConcurrent>
+
+namespace {
+// splitmix64 finalizer: a well-mixed 64-bit hash of the inputs
+quint64 mix(quint64 x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+double dayRoll(quint32 seed, int day) {
+    return (mix((quint64(seed) << 32) | quint32(day)) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+const int ParallelThreshold = 4096;
+}
+
+void stepPlant(Plant& plant, int day) {
+    const PlantGenome& g = plant.genome;
+    plant.age++;
+    plant.hydration = qMax(0.0f, plant.hydration - 0.12f * g.waterUseRate);
+    plant.nutrients = qMax(0.0f, plant.nutrients - 0.06f * g.nutrientUseRate);
+
+    float growthStress = 0.0f;
+    if (plant.hydration < 0.5f) growthStress += 0.2f;
+    if (plant.nutrients < 0.5f) growthStress += 0.2f;
+
+    if (growthStress > 0.0f)
+        plant.health = qMax(0.0f, plant.health - growthStress * 0.25f);
+    else
+        plant.health = qMin(1.0f, plant.health + g.recoveryRate * 0.1f);
+
+    if (plant.isFemale && dayRoll(plant.seed, day) < g.hermieChance * growthStress)
+        plant.isHermie = true;
+}
+
+void stepGarden(QList<Plant>& plants, int day) {
+    if (plants.size() < ParallelThreshold) {
+        for (Plant& p : plants) stepPlant(p, day);
+        return;
+    }
+    QtConcurrent::blockingMap(plants, [day](Plant& p) { stepPlant(p, day); });
+}
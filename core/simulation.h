@@ -0,0 +1,17 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <QList>
+
+#include "plant.h"
+
+// One simulated day for a plant: ages it, draws down water and food, moves
+// health, and rolls stress hermies. Randomness is a hash of (plant.seed, day)
+// rather than a shared generator, so any day can be replayed and gives the
+// same result regardless of order or thread.
+void stepPlant(Plant& plant, int day);
+
+// stepPlant over the whole garden; large gardens are split across threads
+void stepGarden(QList<Plant>& plants, int day);
+
+#endif // SIMULATION_H
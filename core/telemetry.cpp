@@ -0,0 +1,212 @@
+#include "telemetry.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+
+namespace {
+const qint64 MinuteMs = 60 * 1000;
+const qint64 HourMs = 60 * MinuteMs;
+
+struct BucketKey {
+    int tent;
+    int sensor;
+    qint64 bucket;
+};
+
+bool operator==(const BucketKey& a, const BucketKey& b) {
+    return a.tent == b.tent && a.sensor == b.sensor && a.bucket == b.bucket;
+}
+
+uint qHash(const BucketKey& key, uint seed = 0) {
+    return ::qHash(key.bucket, seed) ^ ::qHash(key.tent * SensorCount + key.sensor, seed);
+}
+
+const char* rollupTable(RollupSize size) {
+    return size == RollupSize::Minute ? "telemetry_minute" : "telemetry_hour";
+}
+
+void accumulate(QHash<BucketKey, Rollup>& buckets, const Reading& r, qint64 width) {
+    BucketKey key{r.tent, int(r.sensor), r.time - r.time % width};
+    Rollup& b = buckets[key];
+    if (b.count == 0) {
+        b.bucket = key.bucket;
+        b.min = b.max = r.value;
+    }
+    b.count++;
+    b.sum += r.value;
+    b.min = qMin(b.min, double(r.value));
+    b.max = qMax(b.max, double(r.value));
+}
+
+bool upsert(QSqlDatabase& db, RollupSize size, const QHash<BucketKey, Rollup>& buckets, QString* error) {
+    QSqlQuery q(db);
+    q.prepare(QString("INSERT INTO %1 (tent, sensor, bucket, n, total, lo, hi) VALUES (?, ?, ?, ?, ?, ?, ?) "
+                      "ON CONFLICT(tent, sensor, bucket) DO UPDATE SET n = n + excluded.n, total = total + excluded.total, "
+                      "lo = MIN(lo, excluded.lo), hi = MAX(hi, excluded.hi)").arg(rollupTable(size)));
+    for (auto it = buckets.constBegin(); it != buckets.constEnd(); ++it) {
+        q.addBindValue(it.key().tent);
+        q.addBindValue(it.key().sensor);
+        q.addBindValue(it.key().bucket);
+        q.addBindValue(it->count);
+        q.addBindValue(it->sum);
+        q.addBindValue(it->min);
+        q.addBindValue(it->max);
+        if (!q.exec()) {
+            *error = q.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+QString sensorName(Sensor sensor) {
+    switch (sensor) {
+    case Sensor::Temperature: return "temp";
+    case Sensor::Humidity: return "humidity";
+    case Sensor::Moisture: return "moisture";
+    }
+    return QString();
+}
+
+bool parseSensor(const QString& name, Sensor* sensor) {
+    for (int i = 0; i < SensorCount; ++i) {
+        if (name.compare(sensorName(Sensor(i)), Qt::CaseInsensitive) == 0) {
+            *sensor = Sensor(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseReading(const QByteArray& line, qint64 now, Reading* reading) {
+    QList<QByteArray> fields = line.simplified().split(' ');
+    if (fields.size() < 3 || fields.size() > 4) return false;
+    bool ok = false;
+    reading->tent = fields[0].toInt(&ok);
+    if (!ok || !parseSensor(QString::fromLatin1(fields[1]), &reading->sensor)) return false;
+    reading->value = fields[2].toFloat(&ok);
+    if (!ok) return false;
+    reading->time = fields.size() == 4 ? fields[3].toLongLong(&ok) : now;
+    return ok;
+}
+
+TelemetryStore::TelemetryStore(const QString& connection) : connection(connection) {
+}
+
+TelemetryStore::~TelemetryStore() {
+    close();
+}
+
+bool TelemetryStore::open(const QString& path) {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(path);
+    if (!db.open()) {
+        error = db.lastError().text();
+        return false;
+    }
+    QSqlQuery q(db);
+    // WAL lets readers (the dashboard) query while the writer appends
+    q.exec("PRAGMA journal_mode=WAL");
+    q.exec("PRAGMA synchronous=NORMAL");
+    q.exec("CREATE TABLE IF NOT EXISTS telemetry (tent INT, sensor INT, t INT, value REAL)");
+    q.exec("CREATE INDEX IF NOT EXISTS telemetry_by_tent ON telemetry (tent, sensor, t)");
+    for (RollupSize size : {RollupSize::Minute, RollupSize::Hour}) {
+        if (!q.exec(QString("CREATE TABLE IF NOT EXISTS %1 (tent INT, sensor INT, bucket INT, n INT, total REAL, lo REAL, hi REAL, "
+                            "PRIMARY KEY (tent, sensor, bucket)) WITHOUT ROWID").arg(rollupTable(size)))) {
+            error = q.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+void TelemetryStore::close() {
+    if (!QSqlDatabase::contains(connection)) return;
+    QSqlDatabase::database(connection, false).close();
+    QSqlDatabase::removeDatabase(connection);
+}
+
+bool TelemetryStore::append(const QVector<Reading>& batch) {
+    if (batch.isEmpty()) return true;
+    QSqlDatabase db = QSqlDatabase::database(connection, false);
+    if (!db.transaction()) {
+        error = db.lastError().text();
+        return false;
+    }
+
+    QHash<BucketKey, Rollup> minutes, hours;
+    QSqlQuery q(db);
+    q.prepare("INSERT INTO telemetry (tent, sensor, t, value) VALUES (?, ?, ?, ?)");
+    bool ok = true;
+    for (const Reading& r : batch) {
+        q.addBindValue(r.tent);
+        q.addBindValue(int(r.sensor));
+        q.addBindValue(r.time);
+        q.addBindValue(r.value);
+        if (!q.exec()) {
+            error = q.lastError().text();
+            ok = false;
+            break;
+        }
+        accumulate(minutes, r, MinuteMs);
+        accumulate(hours, r, HourMs);
+    }
+    ok = ok && upsert(db, RollupSize::Minute, minutes, &error) && upsert(db, RollupSize::Hour, hours, &error);
+    if (!ok) {
+        db.rollback();
+        return false;
+    }
+    if (!db.commit()) {
+        error = db.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+QVector<Rollup> TelemetryStore::rollups(int tent, Sensor sensor, RollupSize size, qint64 from, qint64 to) const {
+    QVector<Rollup> out;
+    QSqlQuery q(QSqlDatabase::database(connection, false));
+    q.setForwardOnly(true);
+    q.prepare(QString("SELECT bucket, n, total, lo, hi FROM %1 WHERE tent = ? AND sensor = ? AND bucket >= ? AND bucket < ? "
+                      "ORDER BY bucket").arg(rollupTable(size)));
+    q.addBindValue(tent);
+    q.addBindValue(int(sensor));
+    q.addBindValue(from);
+    q.addBindValue(to);
+    if (!q.exec()) return out;
+    while (q.next()) {
+        Rollup r;
+        r.bucket = q.value(0).toLongLong();
+        r.count = q.value(1).toInt();
+        r.sum = q.value(2).toDouble();
+        r.min = q.value(3).toDouble();
+        r.max = q.value(4).toDouble();
+        out.append(r);
+    }
+    return out;
+}
+
+QVector<Reading> TelemetryStore::readings(int tent, Sensor sensor, qint64 from, qint64 to) const {
+    QVector<Reading> out;
+    QSqlQuery q(QSqlDatabase::database(connection, false));
+    q.setForwardOnly(true);
+    q.prepare("SELECT t, value FROM telemetry WHERE tent = ? AND sensor = ? AND t >= ? AND t < ? ORDER BY t");
+    q.addBindValue(tent);
+    q.addBindValue(int(sensor));
+    q.addBindValue(from);
+    q.addBindValue(to);
+    if (!q.exec()) return out;
+    while (q.next()) {
+        Reading r;
+        r.time = q.value(0).toLongLong();
+        r.tent = tent;
+        r.sensor = sensor;
+        r.value = q.value(1).toFloat();
+        out.append(r);
+    }
+    return out;
+}
@@ -0,0 +1,69 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+// Sensor readings per tent, stored as an append-only time series with minute
+// and hour rollups kept up to date on every write.
+//
+// Readings arrive as text lines "tent sensor value [time_ms]", where sensor
+// is temp, humidity or moisture and time defaults to when it was received.
+
+enum class Sensor : quint8 { Temperature = 0, Humidity, Moisture };
+const int SensorCount = 3;
+
+QString sensorName(Sensor sensor);
+bool parseSensor(const QString& name, Sensor* sensor);
+
+struct Reading {
+    qint64 time = 0;  // ms since epoch
+    int tent = 0;
+    Sensor sensor = Sensor::Temperature;
+    float value = 0;
+};
+
+// One text line; now fills in a missing timestamp
+bool parseReading(const QByteArray& line, qint64 now, Reading* reading);
+
+enum class RollupSize { Minute, Hour };
+
+struct Rollup {
+    qint64 bucket = 0;  // start of the minute or hour, ms since epoch
+    int count = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+
+    double mean() const { return count ? sum / count : 0; }
+};
+
+// SQLite storage on its own connection, which like any QSqlDatabase must only
+// be used from the thread that opened it.
+class TelemetryStore {
+public:
+    explicit TelemetryStore(const QString& connection = "telemetry");
+    ~TelemetryStore();
+
+    bool open(const QString& path);
+    void close();
+
+    // Appends a batch in one transaction: the raw rows, then one upsert per
+    // minute and hour bucket the batch touched
+    bool append(const QVector<Reading>& batch);
+
+    // Rollups for one tent and sensor with from <= bucket < to, oldest first
+    QVector<Rollup> rollups(int tent, Sensor sensor, RollupSize size, qint64 from, qint64 to) const;
+    QVector<Reading> readings(int tent, Sensor sensor, qint64 from, qint64 to) const;
+
+    QString errorString() const { return error; }
+
+private:
+    QString connection;
+    QString error;
+};
+
+Q_DECLARE_METATYPE(Reading)
+
+#endif // TELEMETRY_H
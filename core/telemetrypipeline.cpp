@@ -0,0 +1,110 @@
+#include "telemetrypipeline.h"
+
+#include <QElapsedTimer>
+#include <QTimer>
+
+namespace {
+const int FlushSize = 5000;
+const int FlushIntervalMs = 250;
+// If the disk can't keep up, shed new readings past this rather than grow without bound
+const int MaxPending = 500000;
+}
+
+TelemetryWriter::TelemetryWriter(const QString& path, QObject* parent)
+    : QObject(parent), path(path), store("telemetry-writer") {
+}
+
+bool TelemetryWriter::start(QString* error) {
+    if (!store.open(path)) {
+        *error = QString("%1: %2").arg(path, store.errorString());
+        return false;
+    }
+    pending.reserve(FlushSize * 2);
+    timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, &TelemetryWriter::flush);
+    timer->start(FlushIntervalMs);
+    return true;
+}
+
+void TelemetryWriter::add(const QVector<Reading>& readings) {
+    int room = MaxPending - pending.size();
+    if (readings.size() > room) {
+        dropped += readings.size() - qMax(0, room);
+        pending += readings.mid(0, qMax(0, room));
+    } else {
+        pending += readings;
+    }
+    if (pending.size() >= FlushSize) flush();
+}
+
+void TelemetryWriter::flush() {
+    if (pending.isEmpty()) return;
+    QElapsedTimer clock;
+    clock.start();
+    if (!store.append(pending)) {
+        // Keep the batch for the next attempt; MaxPending bounds how long that can go on
+        emit writeFailed(store.errorString());
+        return;
+    }
+    QVector<Reading> batch;
+    batch.swap(pending);
+    pending.reserve(FlushSize * 2);
+    emit batchWritten(batch.size(), clock.elapsed(), dropped);
+    emit stored(batch);
+}
+
+TelemetryPipeline::TelemetryPipeline(const QString& dbPath, QObject* parent)
+    : QObject(parent), writer(new TelemetryWriter(dbPath)) {
+    thread.setObjectName("telemetry");
+    qRegisterMetaType<QVector<Reading>>();
+    connect(writer, &TelemetryWriter::batchWritten, this, &TelemetryPipeline::batchWritten);
+    connect(writer, &TelemetryWriter::stored, this, &TelemetryPipeline::batchStored);
+    connect(writer, &TelemetryWriter::writeFailed, this, &TelemetryPipeline::writeFailed);
+}
+
+TelemetryPipeline::~TelemetryPipeline() {
+    stop();
+}
+
+void TelemetryPipeline::addSource(TelemetrySource* source) {
+    source->setParent(nullptr);
+    sources.append(source);
+    connect(source, &TelemetrySource::readingsReady, writer, &TelemetryWriter::add);
+}
+
+bool TelemetryPipeline::start(QString* error) {
+    writer->moveToThread(&thread);
+    for (TelemetrySource* source : sources) source->moveToThread(&thread);
+    thread.start();
+
+    bool ok = false;
+    QMetaObject::invokeMethod(writer, [&]() {
+        ok = writer->start(error);
+        for (int i = 0; ok && i < sources.size(); ++i) ok = sources[i]->start(error);
+    }, Qt::BlockingQueuedConnection);
+    if (!ok) stop();
+    return ok;
+}
+
+void TelemetryPipeline::stop() {
+    if (!writer) return;
+    if (thread.isRunning()) {
+        // Tear down on the ingest thread, where the sockets and timers live
+        // (deleteLater: they are destroyed as the thread finishes)
+        QMetaObject::invokeMethod(writer, [this]() {
+            for (TelemetrySource* source : sources) {
+                source->disconnect();
+                source->deleteLater();
+            }
+            writer->flush();
+            writer->deleteLater();
+        }, Qt::BlockingQueuedConnection);
+        thread.quit();
+        thread.wait();
+    } else {
+        qDeleteAll(sources);
+        delete writer;
+    }
+    sources.clear();
+    writer = nullptr;
+}
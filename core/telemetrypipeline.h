@@ -0,0 +1,68 @@
+#ifndef TELEMETRYPIPELINE_H
+#define TELEMETRYPIPELINE_H
+
+#include <QThread>
+
+#include "telemetry.h"
+#include "telemetrysources.h"
+
+class QTimer;
+
+// Collects readings from the sources into batches and appends them to the
+// store: every FlushSize readings, or every FlushIntervalMs, whichever first.
+// Lives on the ingest thread with the sources.
+class TelemetryWriter : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TelemetryWriter(const QString& path, QObject* parent = nullptr);
+
+    bool start(QString* error);
+    void add(const QVector<Reading>& readings);
+    void flush();
+
+signals:
+    void batchWritten(int count, qint64 elapsedMs, qint64 dropped);
+    // The readings just committed, for consumers that follow the stream
+    void stored(const QVector<Reading>& batch);
+    void writeFailed(const QString& error);
+
+private:
+    QString path;
+    TelemetryStore store;
+    QVector<Reading> pending;
+    QTimer* timer = nullptr;
+    qint64 dropped = 0;
+};
+
+// Runs the sources and the writer on their own thread, so parsing and SQLite
+// commits never hold up the thread that owns the pipeline.
+class TelemetryPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TelemetryPipeline(const QString& dbPath, QObject* parent = nullptr);
+    ~TelemetryPipeline();
+
+    // Takes ownership; add every source before start()
+    void addSource(TelemetrySource* source);
+    const QList<TelemetrySource*>& sourceList() const { return sources; }
+
+    // Opens the store and every source on the ingest thread, waiting for the result
+    bool start(QString* error);
+    // Flushes what is pending and stops the thread
+    void stop();
+
+signals:
+    // Delivered on the owner's thread
+    void batchWritten(int count, qint64 elapsedMs, qint64 dropped);
+    void batchStored(const QVector<Reading>& batch);
+    void writeFailed(const QString& error);
+
+private:
+    QThread thread;
+    TelemetryWriter* writer;
+    QList<TelemetrySource*> sources;
+};
+
+#endif // TELEMETRYPIPELINE_H
@@ -0,0 +1,182 @@
+#include "telemetrysources.h"
+
+#include <QDateTime>
+#include <QNetworkDatagram>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <QUdpSocket>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void TelemetrySource::takeLines(QByteArray& buffer) {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QVector<Reading> batch;
+    int start = 0;
+    int end;
+    while ((end = buffer.indexOf('\n', start)) >= 0) {
+        QByteArray line = buffer.mid(start, end - start);
+        start = end + 1;
+        if (line.trimmed().isEmpty()) continue;
+        Reading r;
+        if (parseReading(line, now, &r)) batch.append(r);
+        else rejected++;
+    }
+    buffer.remove(0, start);
+    if (!batch.isEmpty()) emit readingsReady(batch);
+}
+
+UdpTelemetrySource::UdpTelemetrySource(const QHostAddress& address, quint16 port, QObject* parent)
+    : TelemetrySource(parent), address(address), port(port) {
+}
+
+bool UdpTelemetrySource::start(QString* error) {
+    socket = new QUdpSocket(this);
+    if (!socket->bind(address, port)) {
+        *error = QString("UDP %1: %2").arg(describe(), socket->errorString());
+        return false;
+    }
+    // Room for bursts while the writer is committing
+    socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 1 << 20);
+    connect(socket, &QUdpSocket::readyRead, this, &UdpTelemetrySource::readDatagrams);
+    return true;
+}
+
+QString UdpTelemetrySource::describe() const {
+    return QString("udp %1:%2").arg(address.toString()).arg(port);
+}
+
+void UdpTelemetrySource::readDatagrams() {
+    while (socket->hasPendingDatagrams()) {
+        QByteArray data = socket->receiveDatagram().data();
+        data.append('\n'); // a datagram always ends its last line
+        takeLines(data);
+    }
+}
+
+StreamTelemetrySource::StreamTelemetrySource(const QString& path, QObject* parent)
+    : TelemetrySource(parent), path(path) {
+}
+
+StreamTelemetrySource::~StreamTelemetrySource() {
+#ifdef Q_OS_UNIX
+    if (fd >= 0) ::close(fd);
+#endif
+}
+
+bool StreamTelemetrySource::start(QString* error) {
+#ifdef Q_OS_UNIX
+    QByteArray native = path.toLocal8Bit();
+    struct stat info;
+    if (::stat(native.constData(), &info) != 0) {
+        *error = QString("%1: %2").arg(path, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    // Holding a FIFO open for writing too means it never reads as end-of-file
+    // between writers, which would otherwise wake us continuously
+    int mode = S_ISFIFO(info.st_mode) ? O_RDWR : O_RDONLY;
+    fd = ::open(native.constData(), mode | O_NONBLOCK | O_CLOEXEC | O_NOCTTY);
+    if (fd < 0) {
+        *error = QString("%1: %2").arg(path, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &StreamTelemetrySource::readAvailable);
+    return true;
+#else
+    *error = QString("%1: reading from pipes and devices is only supported on Unix").arg(path);
+    return false;
+#endif
+}
+
+QString StreamTelemetrySource::describe() const {
+    return "stream " + path;
+}
+
+void StreamTelemetrySource::readAvailable() {
+#ifdef Q_OS_UNIX
+    char chunk[64 * 1024];
+    for (;;) {
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            buffer.append(chunk, int(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            // The device went away; stop listening rather than spin on it
+            qWarning("%s: %s", qPrintable(path), n == 0 ? "closed" : strerror(errno));
+            notifier->setEnabled(false);
+        }
+        break;
+    }
+    takeLines(buffer);
+#endif
+}
+
+SimulatedTelemetrySource::SimulatedTelemetrySource(int tents, int readingsPerSecond, quint32 seed, QObject* parent)
+    : TelemetrySource(parent), tents(qMax(1, tents)), rate(qMax(1, readingsPerSecond)), rng(seed) {
+    level.resize(this->tents * SensorCount);
+    for (int t = 0; t < this->tents; ++t) {
+        level[t * SensorCount + int(Sensor::Temperature)] = 24.0f;
+        level[t * SensorCount + int(Sensor::Humidity)] = 55.0f;
+        level[t * SensorCount + int(Sensor::Moisture)] = 0.7f;
+    }
+}
+
+bool SimulatedTelemetrySource::start(QString*) {
+    timer = new QTimer(this);
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &SimulatedTelemetrySource::tick);
+    clock.start();
+    timer->start(10);
+    return true;
+}
+
+QString SimulatedTelemetrySource::describe() const {
+    return QString("simulator %1 tents at %2 readings/s").arg(tents).arg(rate);
+}
+
+QVector<Reading> SimulatedTelemetrySource::generate(int count, qint64 now) {
+    QVector<Reading> batch;
+    batch.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        int slot = cursor;
+        cursor = (cursor + 1) % level.size();
+        Sensor sensor = Sensor(slot % SensorCount);
+        float& v = level[slot];
+        float step = float(rng.generateDouble() - 0.5);
+        switch (sensor) {
+        case Sensor::Temperature:
+            v = qBound(15.0f, v + step * 0.2f, 35.0f);
+            break;
+        case Sensor::Humidity:
+            v = qBound(20.0f, v + step * 0.5f, 95.0f);
+            break;
+        case Sensor::Moisture:
+            // Dries slowly, and now and then gets watered back up
+            v = rng.bounded(20000) == 0 ? 0.9f : qMax(0.05f, v - 0.00002f + step * 0.0005f);
+            break;
+        }
+        Reading r;
+        r.time = now;
+        r.tent = slot / SensorCount + 1;
+        r.sensor = sensor;
+        r.value = v;
+        batch.append(r);
+    }
+    return batch;
+}
+
+void SimulatedTelemetrySource::tick() {
+    // Catch up to the rate by the clock, so a late tick doesn't lose readings
+    qint64 due = clock.elapsed() * rate / 1000 - emitted;
+    if (due <= 0) return;
+    emitted += due;
+    emit readingsReady(generate(int(due), QDateTime::currentMSecsSinceEpoch()));
+}
@@ -0,0 +1,103 @@
+#ifndef TELEMETRYSOURCES_H
+#define TELEMETRYSOURCES_H
+
+#include <QHostAddress>
+#include <QObject>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include "telemetry.h"
+
+class QTimer;
+class QUdpSocket;
+class QSocketNotifier;
+
+// Somewhere readings come from. Sources are created on the owner's thread and
+// handed to a TelemetryPipeline, which calls start() on its ingest thread.
+class TelemetrySource : public QObject {
+    Q_OBJECT
+
+public:
+    using QObject::QObject;
+
+    // Opens sockets, files and timers; runs on the thread the source lives on
+    virtual bool start(QString* error) = 0;
+    virtual QString describe() const = 0;
+
+    qint64 rejectedLines() const { return rejected; }
+
+signals:
+    void readingsReady(const QVector<Reading>& readings);
+
+protected:
+    // Parses the complete lines at the front of buffer and leaves any partial one
+    void takeLines(QByteArray& buffer);
+
+private:
+    qint64 rejected = 0;
+};
+
+// Datagrams of one or more reading lines
+class UdpTelemetrySource : public TelemetrySource {
+    Q_OBJECT
+
+public:
+    UdpTelemetrySource(const QHostAddress& address, quint16 port, QObject* parent = nullptr);
+    bool start(QString* error) override;
+    QString describe() const override;
+
+private:
+    void readDatagrams();
+
+    QHostAddress address;
+    quint16 port;
+    QUdpSocket* socket = nullptr;
+};
+
+// A named pipe, or a character device such as a serial port already set up
+// with stty (e.g. stty -F /dev/ttyUSB0 115200 raw). Unix only.
+class StreamTelemetrySource : public TelemetrySource {
+    Q_OBJECT
+
+public:
+    explicit StreamTelemetrySource(const QString& path, QObject* parent = nullptr);
+    ~StreamTelemetrySource();
+    bool start(QString* error) override;
+    QString describe() const override;
+
+private:
+    void readAvailable();
+
+    QString path;
+    int fd = -1;
+    QSocketNotifier* notifier = nullptr;
+    QByteArray buffer;
+};
+
+// Stand-in for real sensors: a random walk per tent and sensor at a fixed
+// total rate, deterministic for a given seed
+class SimulatedTelemetrySource : public TelemetrySource {
+    Q_OBJECT
+
+public:
+    SimulatedTelemetrySource(int tents, int readingsPerSecond, quint32 seed = 1, QObject* parent = nullptr);
+    bool start(QString* error) override;
+    QString describe() const override;
+
+    // The next count readings, as start() would emit them; for benchmarks
+    QVector<Reading> generate(int count, qint64 now);
+
+private:
+    void tick();
+
+    int tents;
+    int rate;
+    QRandomGenerator rng;
+    QVector<float> level; // current value per tent * SensorCount + sensor
+    int cursor = 0;
+    qint64 emitted = 0;
+    QElapsedTimer clock;
+    QTimer* timer = nullptr;
+};
+
+#endif // TELEMETRYSOURCES_H
@@ -0,0 +1,94 @@
+#include "timeline.h"
+#include "simulation.h"
+
+GardenTimeline::GardenTimeline(int checkpointInterval) : interval(qMax(1, checkpointInterval)) {
+}
+
+void GardenTimeline::reset(const QList<Plant>& plants, int startDay) {
+    checkpoints.clear();
+    actions.clear();
+    baseDay = day = startDay;
+    capture(plants, startDay);
+}
+
+void GardenTimeline::setCheckpointInterval(int days) {
+    interval = qMax(1, days);
+    // Keep the base and anything still on the new grid
+    for (auto it = checkpoints.begin(); it != checkpoints.end();) {
+        if (it.key() != baseDay && (it.key() - baseDay) % interval != 0)
+            it = checkpoints.erase(it);
+        else
+            ++it;
+    }
+}
+
+void GardenTimeline::apply(QList<Plant>& plants, GardenAction action) {
+    for (Plant& p : plants) {
+        if (action == GardenAction::Water) p.hydration = 1.0f;
+        else p.nutrients = 1.0f;
+    }
+}
+
+void GardenTimeline::record(const QList<Plant>& plants, GardenAction action) {
+    actions.insert(day, action);
+    while (!checkpoints.isEmpty() && checkpoints.lastKey() > day)
+        checkpoints.erase(--checkpoints.end());
+    if (checkpoints.contains(day)) capture(plants, day);
+}
+
+void GardenTimeline::capture(const QList<Plant>& plants, int atDay) {
+    QVector<PlantState>& snapshot = checkpoints[atDay];
+    snapshot.resize(plants.size());
+    for (int i = 0; i < plants.size(); ++i) {
+        const Plant& p = plants.at(i);
+        PlantState& s = snapshot[i];
+        s.hydration = p.hydration;
+        s.nutrients = p.nutrients;
+        s.health = p.health;
+        s.age = qint16(p.age);
+        s.isHermie = p.isHermie;
+    }
+}
+
+void GardenTimeline::restore(QList<Plant>& plants, int fromDay) const {
+    const QVector<PlantState> snapshot = checkpoints.value(fromDay);
+    int n = qMin(plants.size(), snapshot.size());
+    for (int i = 0; i < n; ++i) {
+        Plant& p = plants[i];
+        const PlantState& s = snapshot[i];
+        p.hydration = s.hydration;
+        p.nutrients = s.nutrients;
+        p.health = s.health;
+        p.age = s.age;
+        p.isHermie = s.isHermie;
+    }
+}
+
+void GardenTimeline::replayDay(QList<Plant>& plants, int d) {
+    stepGarden(plants, d);
+    for (auto it = actions.constFind(d); it != actions.constEnd() && it.key() == d; ++it)
+        apply(plants, it.value());
+    if ((d - baseDay) % interval == 0 && !checkpoints.contains(d))
+        capture(plants, d);
+}
+
+int GardenTimeline::seek(QList<Plant>& plants, int target) {
+    target = qMax(target, baseDay);
+    if (target == day) return 0;
+
+    // Nearest checkpoint at or before the target; stepping on from the
+    // current day is used instead when it is closer
+    auto it = checkpoints.upperBound(target);
+    --it; // the base snapshot guarantees one exists
+    int from = it.key();
+    if (target < day || target - day > target - from) {
+        restore(plants, from);
+    } else {
+        from = day;
+    }
+
+    for (int d = from + 1; d <= target; ++d)
+        replayDay(plants, d);
+    day = target;
+    return target - from;
+}
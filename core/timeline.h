@@ -0,0 +1,61 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <QList>
+#include <QMap>
+#include <QVector>
+
+#include "plant.h"
+
+// Grower actions recorded against the day they happened
+enum class GardenAction : quint8 { Water, Feed };
+
+// Day-by-day history of a garden for the day slider.
+//
+// The simulation is deterministic (see simulation.h), so the only per-day
+// deltas that need storing are the grower's actions. Full state snapshots are
+// kept every `checkpointInterval` days; seeking restores the nearest one at or
+// before the target and replays the remaining days. Memory is one snapshot
+// per interval, so a longer interval trades scrub latency for memory.
+class GardenTimeline {
+public:
+    explicit GardenTimeline(int checkpointInterval = 10);
+
+    // Start a new history at `day` from the garden as it is now. Needed
+    // whenever plants are added or removed, since snapshots are per index.
+    void reset(const QList<Plant>& plants, int day);
+
+    // Record an action already applied to `plants` on the current day.
+    // Snapshots after today are dropped; recorded future actions are kept.
+    void record(const QList<Plant>& plants, GardenAction action);
+
+    // Bring `plants` to `day`. Returns the number of days simulated.
+    int seek(QList<Plant>& plants, int day);
+
+    int currentDay() const { return day; }
+    int firstDay() const { return baseDay; }
+    int checkpointInterval() const { return interval; }
+    void setCheckpointInterval(int days);
+
+    static void apply(QList<Plant>& plants, GardenAction action);
+
+private:
+    // The mutable part of a Plant; genomes don't change with time
+    struct PlantState {
+        float hydration, nutrients, health;
+        qint16 age;
+        bool isHermie;
+    };
+
+    void capture(const QList<Plant>& plants, int atDay);
+    void restore(QList<Plant>& plants, int fromDay) const;
+    void replayDay(QList<Plant>& plants, int d);
+
+    int interval;
+    int baseDay = 0;
+    int day = 0;
+    QMap<int, QVector<PlantState>> checkpoints;
+    QMultiMap<int, GardenAction> actions;
+};
+
+#endif // TIMELINE_H
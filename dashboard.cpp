@@ -0,0 +1,448 @@
+#include "dashboard.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QSignalBlocker>
+#include <QSqlQuery>
+#include <QVBoxLayout>
+#include <QWheelEvent>
+#include <cmath>
+#include <limits>
+
+namespace {
+const qint64 MinuteMs = 60 * 1000;
+const qint64 HourMs = 60 * MinuteMs;
+const qint64 DayMs = 24 * HourMs;
+
+const int LeftMargin = 64;
+const int AxisHeight = 22;
+const int LaneGap = 6;
+// Labels on the time axis are at least this far apart
+const int TickSpacing = 90;
+
+const int PollIntervalMs = 5000;
+const qint64 EventLagMs = 2000;
+}
+
+TimeChart::TimeChart(QWidget* parent) : QWidget(parent) {
+    setMinimumHeight(300);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+int TimeChart::addSeries(const QString& lane, const QString& name, const QColor& color, Style style, qint64 joinWithin) {
+    Series s;
+    s.lane = lane;
+    s.name = name;
+    s.color = color;
+    s.style = style;
+    s.joinWithin = joinWithin;
+    seriesList.append(s);
+    if (!lanes.contains(lane)) lanes.append(lane);
+    return seriesList.size() - 1;
+}
+
+void TimeChart::clearData() {
+    for (Series& s : seriesList) s.data.clear();
+    dataAppended();
+}
+
+void TimeChart::dataAppended() {
+    if (following) updateFollowedView();
+    update();
+}
+
+void TimeChart::follow(qint64 span) {
+    following = true;
+    followSpan = span;
+    updateFollowedView();
+    update();
+}
+
+void TimeChart::updateFollowedView() {
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 first = now, last = now;
+    for (const Series& s : seriesList) {
+        if (s.data.isEmpty()) continue;
+        first = qMin(first, s.data.firstTime());
+        last = qMax(last, s.data.lastTime());
+    }
+    viewTo = last;
+    viewFrom = followSpan > 0 ? last - followSpan : qMin(first, last - HourMs);
+}
+
+void TimeChart::setView(qint64 from, qint64 to) {
+    following = false;
+    viewFrom = from;
+    viewTo = from + qBound(MinuteMs, to - from, 20 * 366 * DayMs);
+    update();
+}
+
+QRect TimeChart::plotArea() const {
+    return rect().adjusted(LeftMargin, 4, -8, -AxisHeight);
+}
+
+void TimeChart::paintEvent(QPaintEvent*) {
+    QPainter p(this);
+    p.fillRect(rect(), palette().base());
+    const QRect area = plotArea();
+    if (area.width() <= 0 || area.height() <= 0) return;
+    drawTimeAxis(p, area);
+
+    // Marker lanes (events) get a thin strip, value lanes share the rest
+    QVector<double> weights;
+    double total = 0;
+    for (const QString& lane : lanes) {
+        double w = 0.35;
+        for (const Series& s : seriesList)
+            if (s.lane == lane && s.style == Band) w = 1;
+        weights.append(w);
+        total += w;
+    }
+
+    double top = area.top();
+    for (int li = 0; li < lanes.size(); ++li) {
+        const double height = area.height() * weights[li] / total;
+        const QRect lane(area.left(), int(top), area.width(), int(height) - LaneGap);
+        top += height;
+        if (lane.height() < 8) continue;
+
+        QVector<int> members;
+        QVector<QVector<MinMaxBucket>> columns;
+        float lo = std::numeric_limits<float>::max();
+        float hi = -lo;
+        int markerRows = 0;
+        for (int i = 0; i < seriesList.size(); ++i) {
+            const Series& s = seriesList[i];
+            if (s.lane != lanes[li]) continue;
+            members.append(i);
+            columns.append(s.data.columns(viewFrom, viewTo, lane.width()));
+            if (s.style == Markers) {
+                markerRows++;
+                continue;
+            }
+            for (const MinMaxBucket& b : columns.last()) {
+                if (b.isEmpty()) continue;
+                lo = qMin(lo, b.lo);
+                hi = qMax(hi, b.hi);
+            }
+        }
+        if (lo > hi) {
+            lo = 0;
+            hi = 1;
+        } else if (hi - lo < 1e-6f) {
+            lo -= 1;
+            hi += 1;
+        } else {
+            float pad = (hi - lo) * 0.05f;
+            lo -= pad;
+            hi += pad;
+        }
+        auto yOf = [&](float v) { return lane.bottom() - 1 - double(v - lo) / double(hi - lo) * (lane.height() - 2); };
+
+        p.setPen(palette().mid().color());
+        p.drawRect(lane.adjusted(0, 0, -1, -1));
+
+        int row = 0;
+        for (int k = 0; k < members.size(); ++k) {
+            const Series& s = seriesList[members[k]];
+            const QVector<MinMaxBucket>& c = columns[k];
+            p.setPen(s.color);
+            if (s.style == Markers) {
+                int rowHeight = lane.height() / markerRows;
+                int y0 = lane.top() + row * rowHeight + 2;
+                int y1 = y0 + rowHeight - 4;
+                for (int x = 0; x < c.size(); ++x)
+                    if (!c[x].isEmpty()) p.drawLine(lane.left() + x, y0, lane.left() + x, y1);
+                row++;
+                continue;
+            }
+            // Each column is a vertical min-max stroke; neighbours are joined
+            // end to end so steep changes stay one continuous trace
+            int prev = -1;
+            for (int x = 0; x < c.size(); ++x) {
+                const MinMaxBucket& b = c[x];
+                if (b.isEmpty()) continue;
+                const double px = lane.left() + x;
+                p.drawLine(QPointF(px, yOf(b.lo)), QPointF(px, yOf(b.hi)));
+                if (prev >= 0 && b.first - c[prev].last <= s.joinWithin) {
+                    const MinMaxBucket& a = c[prev];
+                    float from = a.hi < b.lo ? a.hi : a.lo > b.hi ? a.lo : (a.lo + a.hi) / 2;
+                    float to = a.hi < b.lo ? b.lo : a.lo > b.hi ? b.hi : (b.lo + b.hi) / 2;
+                    p.drawLine(QPointF(lane.left() + prev, yOf(from)), QPointF(px, yOf(to)));
+                }
+                prev = x;
+            }
+        }
+
+        // Title and legend inside the lane, value range in the margin
+        int x = lane.left() + 6;
+        const int baseline = lane.top() + p.fontMetrics().ascent() + 2;
+        p.setPen(palette().text().color());
+        p.drawText(x, baseline, lanes[li]);
+        x += p.fontMetrics().horizontalAdvance(lanes[li]) + 12;
+        for (int i : members) {
+            p.setPen(seriesList[i].color);
+            p.drawText(x, baseline, seriesList[i].name);
+            x += p.fontMetrics().horizontalAdvance(seriesList[i].name) + 8;
+        }
+        if (markerRows < members.size()) {
+            p.setPen(palette().text().color());
+            QRect margin(0, lane.top(), LeftMargin - 6, lane.height());
+            p.drawText(margin, Qt::AlignRight | Qt::AlignTop, QString::number(hi, 'g', 3));
+            p.drawText(margin, Qt::AlignRight | Qt::AlignBottom, QString::number(lo, 'g', 3));
+        }
+    }
+}
+
+void TimeChart::drawTimeAxis(QPainter& p, const QRect& area) {
+    static const qint64 steps[] = {
+        MinuteMs, 5 * MinuteMs, 15 * MinuteMs, 30 * MinuteMs, HourMs, 3 * HourMs, 6 * HourMs, 12 * HourMs,
+        DayMs, 2 * DayMs, 7 * DayMs, 14 * DayMs, 30 * DayMs, 91 * DayMs, 365 * DayMs
+    };
+    const double msPerPixel = double(viewTo - viewFrom) / area.width();
+    qint64 step = steps[sizeof(steps) / sizeof(steps[0]) - 1];
+    for (qint64 s : steps) {
+        if (s / msPerPixel >= TickSpacing) {
+            step = s;
+            break;
+        }
+    }
+    const char* format = step < 3 * HourMs ? "HH:mm" : step < DayMs ? "ddd HH:mm" : step < 365 * DayMs ? "MMM d" : "yyyy";
+
+    // Ticks fall on local midnights, hours and so on
+    const qint64 offset = qint64(QDateTime::fromMSecsSinceEpoch(viewFrom).offsetFromUtc()) * 1000;
+    for (qint64 t = ((viewFrom + offset) / step + 1) * step - offset; t < viewTo; t += step) {
+        int x = area.left() + int((t - viewFrom) / msPerPixel);
+        p.setPen(palette().midlight().color());
+        p.drawLine(x, area.top(), x, area.bottom() + 3);
+        p.setPen(palette().text().color());
+        p.drawText(x + 3, area.bottom() + AxisHeight - 6, QDateTime::fromMSecsSinceEpoch(t).toString(format));
+    }
+}
+
+void TimeChart::wheelEvent(QWheelEvent* event) {
+    const QRect area = plotArea();
+    const double factor = std::pow(0.8, event->angleDelta().y() / 120.0);
+    const double at = qBound(0.0, double(event->pos().x() - area.left()) / area.width(), 1.0);
+    const qint64 anchor = viewFrom + qint64((viewTo - viewFrom) * at);
+    const qint64 span = qint64((viewTo - viewFrom) * factor);
+    setView(anchor - qint64(span * at), anchor - qint64(span * at) + span);
+    event->accept();
+}
+
+void TimeChart::mousePressEvent(QMouseEvent* event) {
+    if (event->button() != Qt::LeftButton) return;
+    dragX = event->x();
+    dragFrom = viewFrom;
+    dragTo = viewTo;
+}
+
+void TimeChart::mouseMoveEvent(QMouseEvent* event) {
+    if (dragX < 0) return;
+    const qint64 shift = qint64(double(dragX - event->x()) * (dragTo - dragFrom) / qMax(1, plotArea().width()));
+    setView(dragFrom + shift, dragTo + shift);
+}
+
+void TimeChart::mouseReleaseEvent(QMouseEvent*) {
+    dragX = -1;
+}
+
+void TimeChart::mouseDoubleClickEvent(QMouseEvent*) {
+    follow(followSpan);
+}
+
+GrowDashboard::GrowDashboard(const QString& telemetryPath, const EventLog* events, QWidget* parent)
+    : QWidget(parent), telemetryPath(telemetryPath), store("dashboard"), events(events) {
+    tentPicker = new QComboBox;
+    rangePicker = new QComboBox;
+    rangePicker->addItem("Day", DayMs);
+    rangePicker->addItem("Week", 7 * DayMs);
+    rangePicker->addItem("Month", 30 * DayMs);
+    rangePicker->addItem("Year", 365 * DayMs);
+    rangePicker->addItem("All", qint64(0));
+    chart = new TimeChart;
+
+    QHBoxLayout* controls = new QHBoxLayout;
+    controls->addWidget(new QLabel("Tent"));
+    controls->addWidget(tentPicker);
+    controls->addWidget(new QLabel("Show"));
+    controls->addWidget(rangePicker);
+    controls->addStretch();
+    controls->addWidget(new QLabel("Scroll to zoom, drag to pan, double-click to follow"));
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(chart, 1);
+
+    sensorSeries[int(Sensor::Temperature)] = chart->addSeries("Temperature (°C)", "min-max", QColor(214, 69, 65));
+    sensorSeries[int(Sensor::Humidity)] = chart->addSeries("Humidity (%)", "min-max", QColor(52, 120, 198));
+    sensorSeries[int(Sensor::Moisture)] = chart->addSeries("Soil moisture", "min-max", QColor(139, 94, 60));
+    waterSeries = chart->addSeries("Events", "water", QColor(52, 120, 198), TimeChart::Markers);
+    feedSeries = chart->addSeries("Events", "feed", QColor(46, 160, 67), TimeChart::Markers);
+    doneSeries = chart->addSeries("Events", "done", palette().text().color(), TimeChart::Markers);
+    stageSeries[0] = chart->addSeries("Plants", "veg", QColor(52, 120, 198), TimeChart::Band, 2 * DayMs);
+    stageSeries[1] = chart->addSeries("Plants", "flowering", QColor(46, 160, 67), TimeChart::Band, 2 * DayMs);
+    stageSeries[2] = chart->addSeries("Plants", "ready", QColor(200, 140, 20), TimeChart::Band, 2 * DayMs);
+    chart->follow(DayMs);
+
+    openStore();
+    connect(tentPicker, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &GrowDashboard::showTent);
+    connect(rangePicker, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        chart->follow(rangePicker->itemData(index).toLongLong());
+    });
+    connect(&pollTimer, &QTimer::timeout, this, &GrowDashboard::poll);
+    pollTimer.start(PollIntervalMs);
+}
+
+// gardend creates the database with its first reading, which may be after we start
+void GrowDashboard::openStore() {
+    if (storeOpen || !QFileInfo::exists(telemetryPath)) return;
+    storeOpen = store.open(telemetryPath);
+    if (!storeOpen) store.close();
+}
+
+void GrowDashboard::setTelemetryPath(const QString& path) {
+    store.close();
+    storeOpen = false;
+    telemetryPath = path;
+    openStore();
+    // Tent ids start over in another garden, so nothing shown carries over
+    tent = TentSchedule();
+    tents.clear();
+    chart->clearData();
+}
+
+void GrowDashboard::setTents(const QVector<TentSchedule>& list) {
+    const int shown = tent.id;
+    tents = list;
+    int index = -1;
+    {
+        QSignalBlocker blocker(tentPicker);
+        tentPicker->clear();
+        for (int i = 0; i < tents.size(); ++i) {
+            tentPicker->addItem(tents[i].name, tents[i].id);
+            if (tents[i].id == shown) index = i;
+        }
+        tentPicker->setCurrentIndex(index >= 0 ? index : 0);
+    }
+    // Same tent: keep its history and just take the new schedule
+    if (index >= 0) {
+        tent = tents[index];
+        return;
+    }
+    showTent(tentPicker->currentIndex());
+}
+
+void GrowDashboard::showTent(int index) {
+    tent = tents.value(index);
+    chart->clearData();
+    plants.clear();
+    stagesUntil = QDate();
+    if (tent.id == 0) return;
+
+    for (int s = 0; s < SensorCount; ++s) telemetryUntil[s] = 0;
+    fetchTelemetry();
+    eventsUntil = 0;
+    fetchEvents();
+    loadStages();
+    chart->dataAppended();
+}
+
+// Complete minutes since the last fetch; the current one is still filling
+void GrowDashboard::fetchTelemetry() {
+    if (!storeOpen) return;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 until = now - now % MinuteMs - MinuteMs;
+    for (int s = 0; s < SensorCount; ++s) {
+        if (until <= telemetryUntil[s]) continue;
+        MinMaxPyramid& d = chart->data(sensorSeries[s]);
+        for (const Rollup& r : store.rollups(tent.id, Sensor(s), RollupSize::Minute, telemetryUntil[s], until))
+            d.append(r.bucket, float(r.min), float(r.max));
+        telemetryUntil[s] = until;
+    }
+}
+
+// Events since the last fetch, stopping a little short of now: gardend's
+// land in the database a moment after they happen
+void GrowDashboard::fetchEvents() {
+    if (!events) return;
+    const qint64 until = QDateTime::currentMSecsSinceEpoch() - EventLagMs;
+    if (until <= eventsUntil) return;
+    for (const GardenEvent& e : events->events(tent.id, eventsUntil, until)) {
+        int series = e.kind != GardenEventKind::Alert ? doneSeries
+                   : e.action.startsWith("Water") ? waterSeries : feedSeries;
+        chart->data(series).append(e.time, 1);
+    }
+    eventsUntil = until;
+}
+
+void GrowDashboard::plantsChanged() {
+    if (tent.id == 0) return;
+    loadStages();
+    chart->dataAppended();
+}
+
+void GrowDashboard::loadStages() {
+    for (int series : stageSeries) chart->data(series).clear();
+    plants.clear();
+    QSqlQuery q;
+    q.prepare("SELECT start_date, flower_start_date, flower_time_days FROM plants WHERE tent_id = ?");
+    q.addBindValue(tent.id);
+    q.exec();
+    QDate first = QDate::currentDate();
+    while (q.next()) {
+        QDate start = QDate::fromString(q.value(0).toString(), "yyyy-MM-dd");
+        QDate flowering = QDate::fromString(q.value(1).toString(), "yyyy-MM-dd");
+        if (!start.isValid()) start = flowering;
+        if (!start.isValid()) continue;
+        if (!flowering.isValid()) flowering = start.addDays(DefaultVegDays);
+        plants.append({start, flowering, flowering.addDays(q.value(2).toInt())});
+        first = qMin(first, start);
+    }
+    stagesUntil = first.addDays(-1);
+    appendStages(first, QDate::currentDate());
+}
+
+// One point per day with each stage's count, from per-day differences
+void GrowDashboard::appendStages(const QDate& from, const QDate& to) {
+    const int days = int(from.daysTo(to)) + 1;
+    if (days <= 0) return;
+    QVector<int> delta[3];
+    for (QVector<int>& d : delta) d.fill(0, days + 1);
+    auto addSpan = [&](QVector<int>& d, const QDate& start, const QDate& end) {
+        int a = qBound(0, int(from.daysTo(start)), days);
+        int b = qBound(0, int(from.daysTo(end)), days);
+        if (a >= b) return;
+        d[a]++;
+        d[b]--;
+    };
+    const QDate never = to.addDays(1);
+    for (const PlantDates& plant : plants) {
+        addSpan(delta[0], plant.veg, plant.flowering);
+        addSpan(delta[1], plant.flowering, plant.ready);
+        addSpan(delta[2], plant.ready, never);
+    }
+    int count[3] = {0, 0, 0};
+    for (int i = 0; i < days; ++i) {
+        const qint64 time = QDateTime(from.addDays(i)).toMSecsSinceEpoch();
+        for (int s = 0; s < 3; ++s) {
+            count[s] += delta[s][i];
+            chart->data(stageSeries[s]).append(time, float(count[s]));
+        }
+    }
+    stagesUntil = to;
+}
+
+void GrowDashboard::poll() {
+    openStore();
+    if (tent.id == 0) return;
+    fetchTelemetry();
+    fetchEvents();
+    const QDate today = QDate::currentDate();
+    if (stagesUntil.isValid() && stagesUntil < today) appendStages(stagesUntil.addDays(1), today);
+    chart->dataAppended();
+}
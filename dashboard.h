@@ -0,0 +1,125 @@
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QDate>
+
+#include "eventlog.h"
+#include "gardendb.h"
+#include "minmaxpyramid.h"
+#include "telemetry.h"
+
+class QComboBox;
+
+// Stacked time charts sharing one time axis. Each series is a MinMaxPyramid,
+// so painting costs the same for an hour or a year of data. Wheel zooms
+// around the cursor, dragging pans, and a double-click goes back to
+// following the newest data.
+class TimeChart : public QWidget {
+    Q_OBJECT
+
+public:
+    enum Style { Band, Markers };
+
+    explicit TimeChart(QWidget* parent = nullptr);
+
+    // Series with the same lane share a plot; joinWithin is the longest gap
+    // (ms) a Band series draws a line across
+    int addSeries(const QString& lane, const QString& name, const QColor& color,
+                  Style style = Band, qint64 joinWithin = 15 * 60 * 1000);
+    MinMaxPyramid& data(int series) { return seriesList[series].data; }
+    void clearData();
+    // Call after appending: repaints, moving the view along when following
+    void dataAppended();
+
+    // Follow the newest data showing this much of it, or everything for 0
+    void follow(qint64 span);
+
+protected:
+    QSize sizeHint() const override { return QSize(800, 420); }
+    void paintEvent(QPaintEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+private:
+    struct Series {
+        QString lane;
+        QString name;
+        QColor color;
+        Style style;
+        qint64 joinWithin;
+        MinMaxPyramid data;
+    };
+
+    void updateFollowedView();
+    void setView(qint64 from, qint64 to);
+    QRect plotArea() const;
+    void drawTimeAxis(QPainter& p, const QRect& area);
+
+    QVector<Series> seriesList;
+    QStringList lanes;
+    qint64 viewFrom = 0;
+    qint64 viewTo = 1;
+    bool following = true;
+    qint64 followSpan = 0;
+    int dragX = -1;
+    qint64 dragFrom = 0;
+    qint64 dragTo = 0;
+};
+
+// GardenDemo's dashboard: one tent's temperature, humidity and moisture
+// (minute rollups from gardend's telemetry database), its alerts and what
+// was done about them (the event log), and how many of its plants are in
+// veg, flowering or ready. History is read once when a tent is picked; after
+// that only new minutes, events and days are fetched and appended.
+class GrowDashboard : public QWidget {
+    Q_OBJECT
+
+public:
+    GrowDashboard(const QString& telemetryPath, const EventLog* events, QWidget* parent = nullptr);
+
+    // Another garden: its tents come next with setTents()
+    void setTelemetryPath(const QString& path);
+    void setTents(const QVector<TentSchedule>& tents);
+    // Plants were added, moved or edited
+    void plantsChanged();
+
+private:
+    struct PlantDates {
+        QDate veg, flowering, ready;
+    };
+
+    void openStore();
+    void showTent(int index);
+    void fetchTelemetry();
+    void fetchEvents();
+    void loadStages();
+    void appendStages(const QDate& from, const QDate& to);
+    void poll();
+
+    QComboBox* tentPicker;
+    QComboBox* rangePicker;
+    TimeChart* chart;
+    QTimer pollTimer;
+
+    QString telemetryPath;
+    TelemetryStore store;
+    bool storeOpen = false;
+    const EventLog* events;
+
+    QVector<TentSchedule> tents;
+    TentSchedule tent;
+    int sensorSeries[SensorCount];
+    qint64 telemetryUntil[SensorCount];  // next minute to fetch
+    int waterSeries, feedSeries, doneSeries;
+    qint64 eventsUntil = 0;
+    int stageSeries[3];                  // veg, flowering, ready
+    QVector<PlantDates> plants;          // the tent's plants
+    QDate stagesUntil;                   // last day appended
+};
+
+#endif // DASHBOARD_H
@@ -16,9 +16,9 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    main.cpp \
-    sunset.cpp
-HEADERS += sunset.h\
+    main.cpp
+
+HEADERS += \
 
 FORMS += \
 
@@ -30,7 +30,9 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 RESOURCES +=
 
 
-LIBS += -L/Users/macbook2015/Desktop/brew/lib -framework GLUT
+include(../core/core.pri)
 
-INCLUDEPATH += /Users/macbook2015/Desktop/brew/include /Users/macbook2015/Desktop/brew/lib
+# Local Homebrew setup on the original development Mac
+macx: LIBS += -L/Users/macbook2015/Desktop/brew/lib -framework GLUT
+macx: INCLUDEPATH += /Users/macbook2015/Desktop/brew/include /Users/macbook2015/Desktop/brew/lib
 
@@ -0,0 +1,165 @@
+#include "gardenserver.h"
+
+#include <QDebug>
+
+namespace {
+// A subscriber this far behind isn't reading; drop it rather than buffer forever
+const qint64 MaxPendingBytes = 4 * 1024 * 1024;
+// Moisture history a new adaptive trend is warmed up from
+const qint64 SeedWindowMs = 24LL * 3600 * 1000;
+const int ExpiryIntervalMs = 10 * 60 * 1000;
+}
+
+GardenServer::GardenServer(QObject* parent) : QObject(parent) {
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    server.setMaxPendingConnections(1024);
+    connect(&server, &QLocalServer::newConnection, this, &GardenServer::acceptClients);
+    connect(&scheduler, &Scheduler::alertDue, this, [this](const ScheduleAlert& alert) {
+        qInfo().noquote() << alert.due.toString("yyyy-MM-dd HH:mm") << alert.action << "tent" << alert.tentName;
+        events.record(GardenEventKind::Alert, alert.tentId, alert.action, alert.tentName);
+        broadcast((GardenFrame(GardenMessage::Alert) << alert).frame());
+    });
+    // Tents whose sensors went quiet fall back to their water days
+    connect(&expiry, &QTimer::timeout, this, [this]() {
+        scheduler.setPredictions(adaptive.expire(QDateTime::currentMSecsSinceEpoch()));
+    });
+    expiry.start(ExpiryIntervalMs);
+}
+
+bool GardenServer::listen(const QString& name) {
+    if (server.listen(name)) {
+        reload();
+        scheduler.start();
+        return true;
+    }
+    // A socket file left by a daemon that died is in the way; one that answers isn't
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(500)) {
+        qWarning() << "gardend is already running on" << name;
+        return false;
+    }
+    QLocalServer::removeServer(name);
+    if (!server.listen(name)) {
+        qWarning() << "Cannot listen on" << name << ":" << server.errorString();
+        return false;
+    }
+    reload();
+    scheduler.start();
+    return true;
+}
+
+void GardenServer::reload() {
+    QVector<TentSchedule> tents = loadTentSchedules();
+    adaptive.setTents(tents);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (history) {
+        for (int id : adaptive.trackedTents()) {
+            if (!adaptive.hasTrend(id))
+                adaptive.seed(id, history->rollups(id, Sensor::Moisture, RollupSize::Minute, now - SeedWindowMs, now));
+        }
+    }
+    scheduler.setTents(tents);
+    scheduler.setPredictions(adaptive.predictions(now));
+    qInfo() << "Loaded" << tents.size() << "tents; next alert" << scheduler.nextDue().toString("yyyy-MM-dd HH:mm");
+}
+
+void GardenServer::attachTelemetry(TelemetryPipeline* pipeline, const QString& path) {
+    history.reset(new TelemetryStore("telemetry-reader"));
+    if (!history->open(path)) {
+        qWarning().noquote() << "Cannot read moisture history from" << path << ":" << history->errorString();
+        history.reset();
+    }
+    connect(pipeline, &TelemetryPipeline::batchStored, this, [this](const QVector<Reading>& batch) {
+        scheduler.setPredictions(adaptive.update(batch, QDateTime::currentMSecsSinceEpoch()));
+    });
+    reload();
+}
+
+bool GardenServer::openEventLog(const QString& path) {
+    QString error;
+    if (!events.open(path, &error)) {
+        qWarning().noquote() << "Cannot open the event log:" << error;
+        return false;
+    }
+    connect(&events, &EventLog::writeFailed, this, [](const QString& error) {
+        qWarning().noquote() << "Event log write failed:" << error;
+    });
+    return true;
+}
+
+void GardenServer::acceptClients() {
+    while (QLocalSocket* socket = server.nextPendingConnection()) {
+        clients.insert(socket, Client());
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readClient(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() { drop(socket); });
+        send(socket, (GardenFrame(GardenMessage::Hello) << databasePath).frame());
+    }
+}
+
+void GardenServer::readClient(QLocalSocket* socket) {
+    auto it = clients.find(socket);
+    if (it == clients.end()) return;
+    it->reader.append(socket->readAll());
+    // Handling a request can drop other clients, so look this one up each time
+    QByteArray payload;
+    while ((it = clients.find(socket)) != clients.end() && it->reader.next(payload))
+        handle(socket, payload);
+    if (it != clients.end() && it->reader.failed()) {
+        qWarning() << "Dropping a client that sent a malformed frame";
+        socket->abort();
+    }
+}
+
+void GardenServer::handle(QLocalSocket* socket, const QByteArray& payload) {
+    QDataStream in(payload);
+    GardenMessage type;
+    if (openGardenPayload(in, type).status() != QDataStream::Ok) {
+        qWarning() << "Dropping a client that sent an empty frame";
+        socket->abort();
+        return;
+    }
+    switch (type) {
+    case GardenMessage::ListTents:
+        send(socket, (GardenFrame(GardenMessage::Tents) << loadTentSchedules()).frame());
+        break;
+    case GardenMessage::ListPlants:
+        send(socket, (GardenFrame(GardenMessage::Plants) << loadPlantRows()).frame());
+        break;
+    case GardenMessage::Subscribe:
+        clients[socket].subscribed = true;
+        break;
+    case GardenMessage::Unsubscribe:
+        clients[socket].subscribed = false;
+        break;
+    case GardenMessage::Changed:
+        reload();
+        broadcast(GardenFrame(GardenMessage::Changed).frame(), socket);
+        break;
+    default:
+        send(socket, (GardenFrame(GardenMessage::Error) << QString("Unknown request %1").arg(int(type))).frame());
+        break;
+    }
+}
+
+void GardenServer::broadcast(const QByteArray& frame, QLocalSocket* except) {
+    QList<QLocalSocket*> slow;
+    for (auto it = clients.constBegin(); it != clients.constEnd(); ++it) {
+        if (!it->subscribed || it.key() == except) continue;
+        if (it.key()->bytesToWrite() > MaxPendingBytes) slow.append(it.key());
+        else it.key()->write(frame);
+    }
+    for (QLocalSocket* socket : slow) {
+        qWarning() << "Dropping a subscriber that stopped reading";
+        socket->abort();
+    }
+}
+
+void GardenServer::send(QLocalSocket* socket, const QByteArray& frame) {
+    socket->write(frame);
+}
+
+void GardenServer::drop(QLocalSocket* socket) {
+    clients.remove(socket);
+    socket->deleteLater();
+}
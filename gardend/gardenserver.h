@@ -0,0 +1,62 @@
+#ifndef GARDENSERVER_H
+#define GARDENSERVER_H
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QHash>
+#include <QScopedPointer>
+#include <QTimer>
+
+#include "adaptivewatering.h"
+#include "eventlog.h"
+#include "gardenproto.h"
+#include "scheduler.h"
+#include "telemetrypipeline.h"
+
+// Serves the garden database and schedule over a local socket. Everything
+// runs on one event loop: requests are answered straight from SQLite, and an
+// alert is encoded once and the same bytes queued on every subscriber.
+class GardenServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit GardenServer(QObject* parent = nullptr);
+
+    // Claims the socket name; false if another daemon already answers on it
+    bool listen(const QString& name);
+    // Sent to each client in its Hello
+    void setDatabasePath(const QString& path) { databasePath = path; }
+    // Re-reads the tents and rebuilds the schedule queue
+    void reload();
+    // Follows the pipeline's readings so adaptive tents water by soil
+    // moisture; path is its database, read for history on reload
+    void attachTelemetry(TelemetryPipeline* pipeline, const QString& path);
+    // Records every alert fired in the events table of this database
+    bool openEventLog(const QString& path);
+
+    int clientCount() const { return clients.size(); }
+
+private:
+    struct Client {
+        GardenFrameReader reader;
+        bool subscribed = false;
+    };
+
+    void acceptClients();
+    void readClient(QLocalSocket* socket);
+    void handle(QLocalSocket* socket, const QByteArray& payload);
+    void broadcast(const QByteArray& frame, QLocalSocket* except = nullptr);
+    void send(QLocalSocket* socket, const QByteArray& frame);
+    void drop(QLocalSocket* socket);
+
+    QLocalServer server;
+    QString databasePath;
+    QHash<QLocalSocket*, Client> clients;
+    Scheduler scheduler;
+    EventLog events;
+    AdaptiveWatering adaptive;
+    QScopedPointer<TelemetryStore> history;
+    QTimer expiry;
+};
+
+#endif // GARDENSERVER_H
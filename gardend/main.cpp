@@ -0,0 +1,106 @@
+// gardend: GardenDemo's schedule without the GUI. Owns the garden database, fires
+// the watering and feeding alerts, and serves tents, plants and alerts to any
+// number of local clients (GardenDemo becomes one of them). It can also take
+// in sensor readings for the tents (see core/telemetry.h).
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QTimer>
+#include <QDebug>
+
+#include "gardendb.h"
+#include "gardenserver.h"
+#include "telemetrypipeline.h"
+
+namespace {
+// "port" or "address:port"
+bool parseUdpOption(const QString& value, QHostAddress* address, quint16* port) {
+    int colon = value.lastIndexOf(':');
+    *address = colon < 0 ? QHostAddress(QHostAddress::LocalHost) : QHostAddress(value.left(colon));
+    bool ok = false;
+    *port = value.mid(colon + 1).toUShort(&ok);
+    return ok && !address->isNull();
+}
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("gardend");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("PlantER garden schedule daemon");
+    parser.addHelpOption();
+    QCommandLineOption dbOption("db", "Garden database (default: garden_demo.db in the PlantER data directory, shared with GardenDemo).",
+                                "file", defaultGardenDbPath());
+    QCommandLineOption socketOption("socket", "Local socket name to listen on.", "name", gardenSocketName());
+    QCommandLineOption telemetryDbOption("telemetry-db", "Sensor time series (default: garden_telemetry.db beside --db).", "file");
+    QCommandLineOption udpOption("udp", "Take readings from UDP datagrams on [address:]port (default address 127.0.0.1).", "port");
+    QCommandLineOption streamOption("stream", "Take readings from a FIFO or serial device, one per line.", "path");
+    QCommandLineOption simulateOption("simulate", "Generate this many simulated readings per second.", "rate");
+    QCommandLineOption simTentsOption("simulate-tents", "Tents the simulator reports for (default 4).", "count", "4");
+    parser.addOption(dbOption);
+    parser.addOption(socketOption);
+    parser.addOption(telemetryDbOption);
+    parser.addOption(udpOption);
+    parser.addOption(streamOption);
+    parser.addOption(simulateOption);
+    parser.addOption(simTentsOption);
+    parser.process(app);
+
+    if (!openGardenDb(parser.value(dbOption))) return 1;
+
+    GardenServer server;
+    server.setDatabasePath(QFileInfo(parser.value(dbOption)).absoluteFilePath());
+    server.openEventLog(parser.value(dbOption));
+    if (!server.listen(parser.value(socketOption))) return 1;
+    qInfo().noquote() << "gardend serving" << parser.value(dbOption) << "on" << parser.value(socketOption);
+
+    QString telemetryDb = parser.value(telemetryDbOption);
+    if (telemetryDb.isEmpty())
+        telemetryDb = QFileInfo(parser.value(dbOption)).absolutePath() + "/garden_telemetry.db";
+    TelemetryPipeline telemetry(telemetryDb);
+    for (const QString& value : parser.values(udpOption)) {
+        QHostAddress address;
+        quint16 port;
+        if (!parseUdpOption(value, &address, &port)) {
+            qWarning().noquote() << "Bad --udp value" << value;
+            return 1;
+        }
+        telemetry.addSource(new UdpTelemetrySource(address, port));
+    }
+    for (const QString& path : parser.values(streamOption))
+        telemetry.addSource(new StreamTelemetrySource(path));
+    if (parser.isSet(simulateOption))
+        telemetry.addSource(new SimulatedTelemetrySource(parser.value(simTentsOption).toInt(), parser.value(simulateOption).toInt()));
+
+    // Report throughput every ten seconds rather than per batch
+    qint64 written = 0, writeMs = 0, dropped = 0;
+    QTimer report;
+    if (!telemetry.sourceList().isEmpty()) {
+        QString error;
+        if (!telemetry.start(&error)) {
+            qWarning().noquote() << "Telemetry:" << error;
+            return 1;
+        }
+        for (TelemetrySource* source : telemetry.sourceList())
+            qInfo().noquote() << "Telemetry from" << source->describe() << "into" << telemetryDb;
+        server.attachTelemetry(&telemetry, telemetryDb);
+        QObject::connect(&telemetry, &TelemetryPipeline::batchWritten, [&](int count, qint64 ms, qint64 totalDropped) {
+            written += count;
+            writeMs += ms;
+            dropped = totalDropped;
+        });
+        QObject::connect(&telemetry, &TelemetryPipeline::writeFailed, [](const QString& error) {
+            qWarning().noquote() << "Telemetry write failed:" << error;
+        });
+        QObject::connect(&report, &QTimer::timeout, [&]() {
+            if (written == 0) return;
+            qInfo().noquote() << QString("Telemetry: %1 readings/s, %2 ms writing, %3 dropped")
+                                 .arg(written / 10).arg(writeMs).arg(dropped);
+            written = writeMs = 0;
+        });
+        report.start(10000);
+    }
+    return app.exec();
+}
@@ -14,15 +14,36 @@
 #include <QHBoxLayout>
 #include <QTimeEdit>
 #include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QSpinBox>
 #include <QGroupBox>
 #include <QComboBox>
 #include <QMessageBox>
 #include <QMediaPlayer>
 #include <QFileDialog>
+#include <QDir>
+#include <QFileInfo>
 #include <QTimer>
 #include <QLabel>
 #include <qcalendarwidget.h>
 #include <QCloseEvent>
+#include <QDockWidget>
+#include <QDialog>
+#include <QFutureWatcher>
+#include <QInputDialog>
+
+#include "dashboard.h"
+#include "eventlog.h"
+#include "gardendb.h"
+#include "gardenclient.h"
+#include "gardenset.h"
+#include "plantindex.h"
+#include "scheduler.h"
+
+namespace {
+// The plant list shows this many matches; the search narrows down the rest
+const int MaxShownPlants = 500;
+}
 
 class GardenDemo : public QMainWindow {
     Q_OBJECT
@@ -32,37 +53,158 @@ public:
         setupDB();
         setupUI();
         setupTray();
-        loadTents();
         checkSchedules();
+        setupDaemon();
+        loadTents();
     }
 
 private:
     QSystemTrayIcon* trayIcon;
     QListWidget* tentList;
     QListWidget* plantList;
+    QLineEdit* plantSearch;
+    QComboBox* stageFilter;
+    QComboBox* tentFilter;
+    QSpinBox* harvestFilter;
+    QLabel* plantCount;
+    QPushButton* weekHarvests;
+    PlantIndex plantIndex;
     QLineEdit* tentNameEdit;
     QLineEdit* plantNameEdit;
     QComboBox* tentSelector;
     QTimeEdit* feed1Time, *feed2Time;
     QCheckBox* feed2xCheck;
     QCheckBox* waterDays[7], *feedDays[7];
+    QCheckBox* adaptiveCheck;
+    QDoubleSpinBox* moistureThreshold;
     QPushButton* soundSelectBtn;
     QString soundPath;
     QMediaPlayer* player = new QMediaPlayer;
-    QTimer* timer;
+    GardenClient* daemon;
+    QString daemonDatabase;  // what gardend served when it last said Hello
+    Scheduler* localScheduler;
+    QTimer* reconnectTimer;
     QCalendarWidget* calendar;
     QLineEdit* flowerInput;
     QPushButton* saveFlowerBtn;
+    GrowDashboard* dashboard;
+    EventLog* events;
+    GardenSet* gardenSet;
+    GardenFile garden;  // the one open on the default connection
+    QComboBox* gardenPicker;
 
     void setupDB() {
-        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
-        db.setDatabaseName(QApplication::applicationDirPath() + "/garden_demo.db");
-        if (!db.open()) {
-            qDebug() << "DB open error:" << db.lastError();
+        importLegacyGardens();
+        // The same files gardend opens by default
+        gardenSet = new GardenSet(defaultGardenDbPath(), gardenDataDir() + "/gardens");
+        garden = gardenSet->gardens().first();
+        openGardenDb(garden.path);
+        events = new EventLog(this);
+        QString error;
+        if (!events->open(garden.path, &error))
+            qDebug() << "Event log:" << error;
+    }
+
+    // Gardens used to live beside the binary; the first start with an empty
+    // data directory copies them over, leaving the old files where they are
+    void importLegacyGardens() {
+        const QString from = QApplication::applicationDirPath();
+        const QString to = gardenDataDir();
+        if (QFileInfo::exists(defaultGardenDbPath()) || !QFileInfo::exists(from + "/garden_demo.db")) return;
+
+        QStringList files;
+        for (const QString& name : QStringList() << "garden_demo.db" << "garden_telemetry.db" << "garden_telemetry.db-wal")
+            if (QFileInfo::exists(from + "/" + name)) files << name;
+        const QStringList patterns = QStringList() << "*.db" << "*.telemetry" << "*.telemetry-wal";
+        for (const QString& name : QDir(from + "/gardens").entryList(patterns, QDir::Files))
+            files << "gardens/" + name;
+
+        QDir().mkpath(to + "/gardens");
+        for (const QString& name : files) {
+            if (!QFile::copy(from + "/" + name, to + "/" + name))
+                qWarning() << "Can't copy" << from + "/" + name << "to" << to;
         }
-        QSqlQuery q;
-        q.exec("CREATE TABLE IF NOT EXISTS tents (id INTEGER PRIMARY KEY, name TEXT, feed2x INT, feed1 TEXT, feed2 TEXT, water_days TEXT, feed_days TEXT, sound TEXT)");
-        q.exec("CREATE TABLE IF NOT EXISTS plants (id INTEGER PRIMARY KEY, name TEXT, tent_id INT, flower_time_days INT,flower_start_date TEXT,start_date TEXT)");
+        qDebug() << "Copied" << files.size() << "garden files from" << from << "to" << to;
+    }
+
+    // Only the garden being looked at is open and loaded; the others stay on disk
+    void openGarden(const GardenFile& next) {
+        if (next.path == garden.path) return;
+        events->close();
+        QSqlDatabase::database().close();
+        QSqlDatabase::removeDatabase(QLatin1String(QSqlDatabase::defaultConnection));
+
+        garden = next;
+        openGardenDb(garden.path);
+        QString error;
+        if (!events->open(garden.path, &error))
+            qDebug() << "Event log:" << error;
+        dashboard->setTelemetryPath(garden.telemetryPath);
+        tentFilter->setCurrentIndex(0);
+        calendar->setDateTextFormat(QDate(), QTextCharFormat());
+
+        // gardend serves one database; any other garden is scheduled here while open
+        if (!daemon->isConnected())
+            daemon->connectToDaemon();
+        else if (!servedByDaemon())
+            daemon->disconnectFromDaemon();
+        if (!daemon->isConnected()) useLocalSchedule();
+        loadTents();
+    }
+
+    bool servedByDaemon() const {
+        const QString served = QFileInfo(daemonDatabase).canonicalFilePath();
+        return !served.isEmpty() && served == QFileInfo(garden.path).canonicalFilePath();
+    }
+
+    void showGardens() {
+        QSignalBlocker blocker(gardenPicker);
+        gardenPicker->clear();
+        for (const GardenFile& g : gardenSet->gardens()) gardenPicker->addItem(g.name);
+        gardenPicker->setCurrentIndex(gardenPicker->findText(garden.name));
+    }
+
+    void addGarden() {
+        QString name = QInputDialog::getText(this, "New Garden", "Garden name:").trimmed();
+        if (name.isEmpty()) return;
+        QString error;
+        if (!gardenSet->create(name, &error)) {
+            QMessageBox::warning(this, "New Garden", error);
+            return;
+        }
+        openGarden(gardenSet->garden(name));
+        showGardens();
+    }
+
+    // Every garden's harvests, each database read on its own thread; the
+    // dialog opens once the last one is done
+    void showWeekHarvests() {
+        const QDate today = QDate::currentDate();
+        weekHarvests->setEnabled(false);
+        auto* watcher = new QFutureWatcher<QVector<GardenHarvest>>(this);
+        connect(watcher, &QFutureWatcher<QVector<GardenHarvest>>::finished, this, [=]() {
+            const QVector<GardenHarvest> due = watcher->result();
+            watcher->deleteLater();
+            weekHarvests->setEnabled(true);
+            showHarvests(due);
+        });
+        watcher->setFuture(gardenSet->harvests(today, today.addDays(6)));
+    }
+
+    void showHarvests(const QVector<GardenHarvest>& due) {
+        QDialog dialog(this);
+        dialog.setWindowTitle("Harvests This Week");
+        QListWidget* list = new QListWidget;
+        for (const GardenHarvest& h : due) {
+            list->addItem(QString("%1  %2: %3 [%4]").arg(h.plant.harvest().toString("ddd d MMM"), h.garden, h.plant.name,
+                                                       h.plant.tentName.isEmpty() ? "No Tent" : h.plant.tentName));
+        }
+        QVBoxLayout* layout = new QVBoxLayout(&dialog);
+        layout->addWidget(new QLabel(QString("%1 plants across %2 gardens")
+                                     .arg(due.size()).arg(gardenSet->gardens().size())));
+        layout->addWidget(list);
+        dialog.resize(420, 360);
+        dialog.exec();
     }
 
     void reassignPlantToTent() {
@@ -80,9 +222,11 @@ private:
         q.addBindValue(plantName);
         if (!q.exec()) {
             qDebug() << "Failed to reassign tent:" << q.lastError().text();
+            return;
         }
 
-        loadPlants(); // refresh UI with new assignment
+        gardenEdited();
+        refreshPlant(plantName);
     }
 
     QMap<int, QColor> tentColorMap = {
@@ -285,6 +429,7 @@ private:
             return;
         }
 
+        refreshPlant(plantName);
         QMessageBox::information(this, "Saved", "Flowering time and start date saved!");
         markPlantDatesOnCalendar();  // Refresh view
     }
@@ -294,8 +439,17 @@ private:
         QWidget* central = new QWidget;
         QHBoxLayout* mainLayout = new QHBoxLayout;
 
-        // Tent side
+        // Tent side, under the garden they are in
         QVBoxLayout* tentLayout = new QVBoxLayout;
+        gardenPicker = new QComboBox;
+        QPushButton* newGarden = new QPushButton("New Garden");
+        weekHarvests = new QPushButton("Harvests This Week");
+        QHBoxLayout* gardenLayout = new QHBoxLayout;
+        gardenLayout->addWidget(new QLabel("Garden"));
+        gardenLayout->addWidget(gardenPicker, 1);
+        gardenLayout->addWidget(newGarden);
+        tentLayout->addLayout(gardenLayout);
+        tentLayout->addWidget(weekHarvests);
         tentList = new QListWidget;
         tentNameEdit = new QLineEdit;
         QPushButton* addTent = new QPushButton("Add Tent");
@@ -305,6 +459,8 @@ private:
         tentLayout->addWidget(tentNameEdit);
         tentLayout->addWidget(addTent);
         tentLayout->addWidget(removeTent);
+        QPushButton* showDashboard = new QPushButton("Dashboard");
+        tentLayout->addWidget(showDashboard);
 
         // Tent config
         QGroupBox* configBox = new QGroupBox("Tent Schedule");
@@ -335,6 +491,20 @@ private:
         configLayout->addWidget(new QLabel("Feed Days"));
         configLayout->addLayout(feedLayout);
 
+        // Needs gardend with moisture telemetry; otherwise the water days apply
+        adaptiveCheck = new QCheckBox("Water by soil moisture");
+        adaptiveCheck->setToolTip("gardend predicts when the soil will reach the threshold from the tent's moisture sensor.\n"
+                                  "Without recent readings the water days above are used.");
+        moistureThreshold = new QDoubleSpinBox;
+        moistureThreshold->setRange(0.05, 0.95);
+        moistureThreshold->setSingleStep(0.05);
+        moistureThreshold->setValue(0.35);
+        QHBoxLayout* adaptiveLayout = new QHBoxLayout;
+        adaptiveLayout->addWidget(adaptiveCheck);
+        adaptiveLayout->addWidget(new QLabel("below"));
+        adaptiveLayout->addWidget(moistureThreshold);
+        configLayout->addLayout(adaptiveLayout);
+
         QPushButton* saveConfig = new QPushButton("Save Tent Config");
         configLayout->addWidget(saveConfig);
         configBox->setLayout(configLayout);
@@ -346,12 +516,36 @@ private:
         // Plant side
         QVBoxLayout* plantLayout = new QVBoxLayout;
         plantList = new QListWidget;
+        plantSearch = new QLineEdit;
+        plantSearch->setPlaceholderText("Search plants and tents");
+        plantSearch->setClearButtonEnabled(true);
+        stageFilter = new QComboBox;
+        stageFilter->addItem("Any stage", -1);
+        stageFilter->addItem("Veg", int(PlantStage::Veg));
+        stageFilter->addItem("Flowering", int(PlantStage::Flowering));
+        stageFilter->addItem("Ready", int(PlantStage::Ready));
+        tentFilter = new QComboBox;
+        tentFilter->addItem("Any tent", -1);
+        harvestFilter = new QSpinBox;
+        harvestFilter->setRange(-1, 365);
+        harvestFilter->setValue(-1);
+        harvestFilter->setSpecialValueText("Any harvest");
+        harvestFilter->setPrefix("Harvest within ");
+        harvestFilter->setSuffix(" days");
+        plantCount = new QLabel;
+        QHBoxLayout* filterLayout = new QHBoxLayout;
+        filterLayout->addWidget(stageFilter);
+        filterLayout->addWidget(tentFilter);
+        filterLayout->addWidget(harvestFilter);
         plantNameEdit = new QLineEdit;
         tentSelector = new QComboBox;
         QPushButton* addPlant = new QPushButton("Add Plant");
         QPushButton* removePlant = new QPushButton("Remove Plant");
         plantLayout->addWidget(new QLabel("Plants"));
+        plantLayout->addWidget(plantSearch);
+        plantLayout->addLayout(filterLayout);
         plantLayout->addWidget(plantList);
+        plantLayout->addWidget(plantCount);
         plantLayout->addWidget(new QLabel("Plant Name"));
         plantLayout->addWidget(plantNameEdit);
         plantLayout->addWidget(new QLabel("Assign to Tent"));
@@ -389,6 +583,16 @@ private:
                 this, &GardenDemo::reassignPlantToTent);
 
         connect(plantList, &QListWidget::itemClicked, this, &GardenDemo::loadPlantToEditor);
+        showGardens();
+        connect(gardenPicker, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+            openGarden(gardenSet->garden(gardenPicker->currentText()));
+        });
+        connect(newGarden, &QPushButton::clicked, this, &GardenDemo::addGarden);
+        connect(weekHarvests, &QPushButton::clicked, this, &GardenDemo::showWeekHarvests);
+        connect(plantSearch, &QLineEdit::textChanged, this, &GardenDemo::showMatches);
+        connect(stageFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &GardenDemo::showMatches);
+        connect(tentFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &GardenDemo::showMatches);
+        connect(harvestFilter, QOverload<int>::of(&QSpinBox::valueChanged), this, &GardenDemo::showMatches);
         connect(addTent, &QPushButton::clicked, this, &GardenDemo::addTent);
         connect(removeTent, &QPushButton::clicked, this, &GardenDemo::removeTent);
         connect(addPlant, &QPushButton::clicked, this, &GardenDemo::addPlant);
@@ -401,6 +605,18 @@ private:
 
         central->setLayout(mainLayout);
         setCentralWidget(central);
+
+        // Charts, below the lists until it is wanted; it can be floated out
+        dashboard = new GrowDashboard(garden.telemetryPath, events);
+        QDockWidget* dashboardDock = new QDockWidget("Dashboard", this);
+        dashboardDock->setObjectName("dashboard");
+        dashboardDock->setWidget(dashboard);
+        addDockWidget(Qt::BottomDockWidgetArea, dashboardDock);
+        dashboardDock->hide();
+        connect(showDashboard, &QPushButton::clicked, this, [dashboardDock]() {
+            dashboardDock->show();
+            dashboardDock->raise();
+        });
         resize(800, 400);
     }
     void showWindow() {
@@ -418,34 +634,93 @@ private:
         trayIcon->setVisible(true);
     }
 
+    // With gardend running the lists come from the daemon; otherwise straight from the database
     void loadTents() {
+        if (daemon->isConnected()) {
+            daemon->requestTents();
+            daemon->requestPlants();
+            return;
+        }
+        showTents(loadTentSchedules());
+        loadPlants();
+    }
+
+    void showTents(const QVector<TentSchedule>& tents) {
+        // Refilling the selector isn't a reassignment by the user
+        QSignalBlocker blockSelector(tentSelector);
+        QSignalBlocker blockFilter(tentFilter);
+        const int filtered = tentFilter->currentData().toInt();
         tentList->clear();
         tentSelector->clear();
-        QSqlQuery q("SELECT id, name FROM tents");
-        while (q.next()) {
-            int id = q.value(0).toInt();
-            QString name = q.value(1).toString();
-            QListWidgetItem* item = new QListWidgetItem(name);
-            item->setData(Qt::UserRole, id);
+        tentFilter->clear();
+        tentFilter->addItem("Any tent", -1);
+        tentFilter->addItem("No tent", 0);
+        for (const TentSchedule& tent : tents) {
+            QListWidgetItem* item = new QListWidgetItem(tent.name);
+            item->setData(Qt::UserRole, tent.id);
             tentList->addItem(item);
-            tentSelector->addItem(name, id);
+            tentSelector->addItem(tent.name, tent.id);
+            tentFilter->addItem(tent.name, tent.id);
         }
-        loadPlants();
+        tentFilter->setCurrentIndex(qMax(0, tentFilter->findData(filtered)));
+        dashboard->setTents(tents);
     }
 
     void loadPlants() {
+        if (daemon->isConnected())
+            daemon->requestPlants();
+        else
+            showPlants(loadPlantRows());
+    }
+
+    void showPlants(const QVector<PlantRow>& rows) {
+        plantIndex.reset(rows);
+        showMatches();
+        dashboard->plantsChanged();
+    }
+
+    // After an edit here only the plants it touched are re-read into the index
+    void refreshPlant(const QString& name) {
+        for (int id : plantIndex.idsNamed(name)) plantIndex.remove(id);
+        for (const PlantRow& row : loadPlantRows(name)) plantIndex.insert(row);
+        showMatches();
+        dashboard->plantsChanged();
+    }
+
+    void showMatches() {
+        PlantQuery query;
+        query.text = plantSearch->text();
+        query.stage = stageFilter->currentData().toInt();
+        query.tentId = tentFilter->currentData().toInt();
+        query.harvestWithin = harvestFilter->value();
+        int total = 0;
+        const QVector<PlantRow> rows = plantIndex.search(query, MaxShownPlants, &total);
+
+        plantList->setUpdatesEnabled(false);
         plantList->clear();
-        QSqlQuery q("SELECT p.name, t.name FROM plants p LEFT JOIN tents t ON p.tent_id = t.id");
-        while (q.next()) {
-            QString plantName = q.value(0).toString();
-            QString tentName = q.value(1).toString();
-            QString displayName = plantName + " [" + (tentName.isEmpty() ? "No Tent" : tentName) + "]";
+        for (const PlantRow& row : rows) {
+            QString displayName = row.name + " [" + (row.tentName.isEmpty() ? "No Tent" : row.tentName) + "]";
             QListWidgetItem* item = new QListWidgetItem(displayName);
-            item->setData(Qt::UserRole, plantName); // keep actual name for logic
+            item->setData(Qt::UserRole, row.name); // keep actual name for logic
             plantList->addItem(item);
         }
+        plantList->setUpdatesEnabled(true);
+
+        if (total > rows.size())
+            plantCount->setText(QString("First %1 of %2 matches").arg(rows.size()).arg(total));
+        else if (query.isEmpty())
+            plantCount->setText(QString("%1 plants").arg(total));
+        else
+            plantCount->setText(QString("%1 of %2 plants").arg(total).arg(plantIndex.size()));
     }
 
+    // The database was edited here: tell gardend, or reschedule locally without it
+    void gardenEdited() {
+        if (daemon->isConnected())
+            daemon->notifyChanged();
+        else
+            localScheduler->setTents(loadTentSchedules());
+    }
 
     void addTent() {
         QString name = tentNameEdit->text();
@@ -454,6 +729,7 @@ private:
         q.prepare("INSERT INTO tents (name, feed2x, feed1, feed2, water_days, feed_days, sound) VALUES (?, 0, '09:00', '18:00', '0000000', '0000000', '')");
         q.addBindValue(name);
         q.exec();
+        gardenEdited();
         loadTents();
     }
 
@@ -465,6 +741,7 @@ private:
         q.prepare("DELETE FROM tents WHERE id=?");
         q.addBindValue(id);
         q.exec();
+        gardenEdited();
         loadTents();
     }
 
@@ -487,6 +764,8 @@ private:
                 waterDays[i]->setChecked(wdays[i] == '1');
                 feedDays[i]->setChecked(fdays[i] == '1');
             }
+            adaptiveCheck->setChecked(q.value("adaptive").toInt());
+            moistureThreshold->setValue(q.value("moisture_threshold").toDouble());
         }
     }
 
@@ -500,15 +779,18 @@ private:
             fdayStr += feedDays[i]->isChecked() ? '1' : '0';
         }
         QSqlQuery q;
-        q.prepare("UPDATE tents SET feed2x=?, feed1=?, feed2=?, water_days=?, feed_days=?, sound=? WHERE id=?");
+        q.prepare("UPDATE tents SET feed2x=?, feed1=?, feed2=?, water_days=?, feed_days=?, sound=?, adaptive=?, moisture_threshold=? WHERE id=?");
         q.addBindValue(feed2xCheck->isChecked() ? 1 : 0);
         q.addBindValue(feed1Time->time().toString("HH:mm"));
         q.addBindValue(feed2Time->time().toString("HH:mm"));
         q.addBindValue(wdayStr);
         q.addBindValue(fdayStr);
         q.addBindValue(soundPath);
+        q.addBindValue(adaptiveCheck->isChecked() ? 1 : 0);
+        q.addBindValue(moistureThreshold->value());
         q.addBindValue(id);
         q.exec();
+        gardenEdited();
     }
 
     void addPlant() {
@@ -527,7 +809,8 @@ private:
         q.addBindValue(60);
         q.exec();
 
-        loadPlants();
+        gardenEdited();
+        refreshPlant(name);
     }
 
     void removePlant() {
@@ -537,40 +820,68 @@ private:
         q.prepare("DELETE FROM plants WHERE name=?");
         q.addBindValue(item);
         q.exec();
-        loadPlants();
+        gardenEdited();
+        refreshPlant(item);
     }
 
+    // Fallback schedule for when gardend isn't running; stopped while connected to it
     void checkSchedules() {
-        timer = new QTimer(this);
-        connect(timer, &QTimer::timeout, this, [&]() {
-            QTime now = QTime::currentTime();
-            int dow = QDate::currentDate().dayOfWeek() % 7; // 0=Sun
-            QSqlQuery q("SELECT * FROM tents");
-            while (q.next()) {
-                QString wdays = q.value("water_days").toString();
-                QString fdays = q.value("feed_days").toString();
-                bool feed2x = q.value("feed2x").toInt();
-                QString feed1 = q.value("feed1").toString();
-                QString feed2 = q.value("feed2").toString();
-                QString sound = q.value("sound").toString();
-                QString tentName = q.value("name").toString();
-
-                auto matchTime = [&](const QString& t) {
-                    return now.toString("HH:mm") == t;
-                };
-
-                if (wdays[dow] == '1' && matchTime(feed1)) {
-                    showAlert("Water", tentName, sound);
-                }
-                if (fdays[dow] == '1' && matchTime(feed1)) {
-                    showAlert("Feed", tentName, sound);
-                }
-                if (feed2x && fdays[dow] == '1' || wdays[dow] == '1' && matchTime(feed2)) {
-                    showAlert("Feed (2x)", tentName, sound);
-                }
+        localScheduler = new Scheduler(this);
+        connect(localScheduler, &Scheduler::alertDue, this, [this](const ScheduleAlert& alert) {
+            events->record(GardenEventKind::Alert, alert.tentId, alert.action, alert.tentName);
+            showAlert(alert.action, alert.tentName, alert.sound);
+            acknowledged(alert);
+        });
+        useLocalSchedule();
+    }
+
+    void useLocalSchedule() {
+        localScheduler->setTents(loadTentSchedules());
+        localScheduler->start();
+    }
+
+    void setupDaemon() {
+        daemon = new GardenClient(this);
+        connect(daemon, &GardenClient::connected, this, [this]() {
+            // A daemon for some other database would serve the wrong lists
+            // and alerts; keep to the local schedule
+            daemonDatabase = daemon->databasePath();
+            if (!servedByDaemon()) {
+                qWarning() << "gardend serves" << daemon->databasePath() << "not" << garden.path;
+                daemon->disconnectFromDaemon();
+                return;
             }
+            localScheduler->stop();
+            daemon->subscribe();
+            loadTents();
+        });
+        connect(daemon, &GardenClient::disconnected, this, [this]() {
+            if (!localScheduler->isRunning()) useLocalSchedule();
+        });
+        connect(daemon, &GardenClient::tentsReceived, this, &GardenDemo::showTents);
+        connect(daemon, &GardenClient::plantsReceived, this, &GardenDemo::showPlants);
+        connect(daemon, &GardenClient::gardenChanged, this, &GardenDemo::loadTents);
+        // gardend logs the alert itself; the acknowledgement is ours
+        connect(daemon, &GardenClient::alertReceived, this, [this](const ScheduleAlert& alert) {
+            showAlert(alert.action, alert.tentName, alert.sound);
+            acknowledged(alert);
         });
-        timer->start(60000); // every 1 min
+        // Pick the daemon up if it is started (or restarted) after the GUI.
+        // Not while it is known to serve another garden: that would only
+        // connect to hear so and hang up again. openGarden() still asks once
+        // per switch, which notices a daemon restarted on another database
+        reconnectTimer = new QTimer(this);
+        connect(reconnectTimer, &QTimer::timeout, this, [this]() {
+            if (daemonDatabase.isEmpty() || servedByDaemon())
+                daemon->connectToDaemon();
+        });
+        reconnectTimer->start(10000);
+        daemon->connectToDaemon();
+    }
+
+    // showAlert() returns when the grower dismisses the message
+    void acknowledged(const ScheduleAlert& alert) {
+        events->record(GardenEventKind::Acknowledged, alert.tentId, alert.action, alert.tentName);
     }
 
     void showAlert(const QString& action, const QString& tentName, const QString& soundFile) {
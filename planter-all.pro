@@ -0,0 +1,22 @@
+# Builds the shared core and every app in dependency order.
+# CMakeLists.txt is the equivalent for CMake builds.
+
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    core \
+    gardendemo \
+    gardend \
+    flowerTime \
+    grower \
+    GanjaFarmer \
+    bench
+
+gardendemo.file = plantER.pro
+grower.file = 420Grower/420Grower.pro
+
+gardendemo.depends = core
+flowerTime.depends = core
+gardend.depends = core
+grower.depends = core
+bench.depends = core